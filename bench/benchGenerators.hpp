@@ -0,0 +1,127 @@
+#include "circuitGenerators.hpp"
+#include "managers.hpp"
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <sys/resource.h>
+#include <vector>
+
+#pragma once
+
+/// @brief An array multiplier with exposed ports a_<i>, b_<i> and p_<i>.
+/// Built from and gates for the partial products and rows of full adders summing them.
+/// The full adder schematic has to outlive the returned schematic.
+inline std::shared_ptr<CircuitSchematic> multiplierSchematic(std::shared_ptr<CircuitSchematic> full_adder, size_t bits)
+{
+    if (bits < 2 || bits * 2 > STORAGE_SIZE) {
+        throw std::runtime_error("Multiplier width out of range");
+    }
+    auto cs = CircuitSchematic::create("multiplier_" + std::to_string(bits));
+    cs->addWireBridge({ { "a", std::vector<size_t>(bits, 1) } });
+    cs->addWireBridge({ { "b", std::vector<size_t>(bits, 1) } });
+    cs->addWireBridge({ { "p", std::vector<size_t>(bits * 2, 1) } });
+    auto partialProduct = [&](size_t row, size_t column) {
+        const std::string gate = "pp" + std::to_string(row) + "_" + std::to_string(column);
+        cs->addAndGate(gate);
+        cs->addConnection("a_" + std::to_string(column), gate + "_a");
+        cs->addConnection("b_" + std::to_string(row), gate + "_b");
+        return gate + "_c";
+    };
+
+    // The running sum, shifted right by one bit after every row
+    std::vector<std::string> sum;
+    for (size_t column = 0; column < bits; column++) {
+        sum.push_back(partialProduct(0, column));
+    }
+    cs->addConnection(sum[0], "p_0");
+    std::string carry;
+    for (size_t row = 1; row < bits; row++) {
+        std::vector<std::string> next_sum;
+        for (size_t column = 0; column < bits; column++) {
+            const std::string fa = "fa" + std::to_string(row) + "_" + std::to_string(column);
+            cs->addSubCircuit(fa, full_adder);
+            const std::string& shifted = column + 1 < bits ? sum[column + 1] : carry;
+            if (!shifted.empty()) {
+                cs->addConnection(shifted, fa + "_input_0");
+            }
+            cs->addConnection(partialProduct(row, column), fa + "_input_1");
+            if (column > 0) {
+                cs->addConnection("fa" + std::to_string(row) + "_" + std::to_string(column - 1) + "_carry_0", fa + "_carryIn_0");
+            }
+            next_sum.push_back(fa + "_sum_0");
+        }
+        carry = "fa" + std::to_string(row) + "_" + std::to_string(bits - 1) + "_carry_0";
+        sum = next_sum;
+        cs->addConnection(sum[0], "p_" + std::to_string(row));
+    }
+    for (size_t column = 1; column < bits; column++) {
+        cs->addConnection(sum[column], "p_" + std::to_string(bits - 1 + column));
+    }
+    cs->addConnection(carry, "p_" + std::to_string(bits * 2 - 1));
+    for (size_t i = 0; i < bits; i++) {
+        cs->addExposedPort("a_" + std::to_string(i));
+        cs->addExposedPort("b_" + std::to_string(i));
+    }
+    for (size_t i = 0; i < bits * 2; i++) {
+        cs->addExposedPort("p_" + std::to_string(i));
+    }
+    return cs;
+}
+
+/// @brief A chain of 2^depth full adders nested depth levels deep.
+/// Every level holds two instances of the level below it and exposes the ports of a full adder.
+/// The returned schematics have to be kept alive together, the last one is the top level.
+inline std::vector<std::shared_ptr<CircuitSchematic>> deepHierarchySchematics(size_t depth)
+{
+    std::vector<std::shared_ptr<CircuitSchematic>> levels { fullAdderSchematic() };
+    for (size_t level = 1; level <= depth; level++) {
+        auto cs = CircuitSchematic::create("level_" + std::to_string(level));
+        cs->addSubCircuit("l", levels.back());
+        cs->addSubCircuit("r", levels.back());
+        cs->addWireBridge({ { "input", { 1, 1 } } });
+        cs->addWireBridge({ { "carryIn", { 1 } } });
+        cs->addWireBridge({ { "sum", { 1 } } });
+        cs->addWireBridge({ { "carry", { 1 } } });
+        for (const char* side : { "l", "r" }) {
+            cs->addConnection("input_0", std::string(side) + "_input_0");
+            cs->addConnection("input_1", std::string(side) + "_input_1");
+        }
+        cs->addConnection("carryIn_0", "l_carryIn_0");
+        cs->addConnection("l_carry_0", "r_carryIn_0");
+        cs->addConnection("r_sum_0", "sum_0");
+        cs->addConnection("r_carry_0", "carry_0");
+        for (const char* port : { "input_0", "input_1", "carryIn_0", "sum_0", "carry_0" }) {
+            cs->addExposedPort(port);
+        }
+        levels.push_back(cs);
+    }
+    return levels;
+}
+
+/// @brief The amount of gates lent by the managers
+inline size_t gateCount(Managers& managers)
+{
+    return managers.andGate->getDataBank().getUsage().bits_used / 3
+        + managers.notGate->getDataBank().getUsage().bits_used / 2
+        + managers.orGate->getDataBank().getUsage().bits_used / 3
+        + managers.xorGate->getDataBank().getUsage().bits_used / 3;
+}
+
+/// @brief The amount of bytes allocated by the data banks of the managers
+inline size_t bankBytes(Managers& managers)
+{
+    const size_t bits = managers.random_access_data_bank->getUsage().bits_allocated
+        + managers.andGate->getDataBank().getUsage().bits_allocated
+        + managers.notGate->getDataBank().getUsage().bits_allocated
+        + managers.orGate->getDataBank().getUsage().bits_allocated
+        + managers.xorGate->getDataBank().getUsage().bits_allocated;
+    return bits / STORAGE_SIZE * sizeof(BoolStorage);
+}
+
+/// @brief The peak resident memory of the process in bytes
+inline size_t peakResidentBytes()
+{
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+}
@@ -0,0 +1,269 @@
+#include "benchGenerators.hpp"
+#include "benchmark.hpp"
+#include "checkpointer.hpp"
+#include "circuitImage.hpp"
+#include "memoryReport.hpp"
+#include "waveformRecorder.hpp"
+#include <filesystem>
+#include <random>
+#include <sstream>
+
+namespace {
+
+/// @brief Benchmark building a schematic into fresh managers. Only build() itself is timed.
+void benchmarkBuild(BenchmarkState& state, const std::shared_ptr<CircuitSchematic>& schematic)
+{
+    std::unique_ptr<Managers> managers;
+    std::shared_ptr<Circuit> circuit;
+    for (auto _ : state) {
+        state.pauseTiming();
+        circuit.reset();
+        managers = std::make_unique<Managers>();
+        state.resumeTiming();
+        circuit = schematic->build(*managers);
+    }
+    state.setRate("gates", gateCount(*managers));
+    state.setRate("sockets", managers->socketController->getSockets().size());
+    state.setCounter("bank_bytes", bankBytes(*managers));
+    MemoryReport report(*managers);
+    report.addCircuit(*circuit);
+    state.setCounter("memory", report.total());
+    state.setCounter("peak_rss", peakResidentBytes());
+}
+
+/// @brief Benchmark mapping an image of a built schematic and running its first tick, the alternative to building it on startup
+void benchmarkImageLoad(BenchmarkState& state, const std::shared_ptr<CircuitSchematic>& schematic)
+{
+    const std::string path = (std::filesystem::temp_directory_path() / "circuitsim_bench.img").string();
+    Managers managers;
+    auto circuit = schematic->build(managers);
+    CircuitImage::write(path, managers, *circuit);
+    for (auto _ : state) {
+        CircuitImage image(path);
+        image.tick();
+    }
+    state.setRate("gates", gateCount(managers));
+    state.setCounter("image_bytes", std::filesystem::file_size(path));
+    std::filesystem::remove(path);
+}
+
+/// @brief A circuit built several times into the same managers, with random values on its exposed ports
+struct Workload {
+    Managers managers;
+    std::vector<std::shared_ptr<Circuit>> circuits;
+
+    Workload(const std::shared_ptr<CircuitSchematic>& schematic, size_t copies, const BuildOptions& options = {})
+    {
+        std::mt19937_64 rng(copies);
+        for (size_t i = 0; i < copies; i++) {
+            circuits.push_back(schematic->build(managers, options));
+            for (auto [name, accessor] : circuits.back()->exposed_ports) {
+                accessor.set(rng() & 1);
+            }
+        }
+    }
+};
+
+/// @brief Benchmark a tick mode on a workload, reporting the gates and sockets it processes
+template <typename Tick>
+void benchmarkTick(BenchmarkState& state, Workload& workload, Tick tick)
+{
+    // The first tick compiles the schedules of the tick modes, which is not what is measured here
+    tick(workload.managers);
+    for (auto _ : state) {
+        tick(workload.managers);
+    }
+    state.setRate("gates", gateCount(workload.managers));
+    state.setRate("sockets", workload.managers.socketController->getSockets().size());
+    state.setCounter("transfers", workload.managers.socketController->getPlan().size());
+    const auto locality = workload.managers.socketController->getLocality(*workload.managers.arena);
+    state.setCounter("socket_distance", locality.distance);
+    state.setCounter("socket_stride", locality.stride);
+}
+
+// The workloads are built on first use and shared by the benchmarks
+auto full_adder = fullAdderSchematic();
+auto ripple_adder = rippleAdderSchematic(full_adder, 64);
+auto multiplier = multiplierSchematic(full_adder, 32);
+auto random_dag = randomSchematic(1, 64, 4096, 64, false);
+auto hierarchy = deepHierarchySchematics(14);
+
+/// @brief A STORAGE_SIZE bit half adder over buses, from gate arrays or from single gates
+std::shared_ptr<CircuitSchematic> halfAdderBus(bool arrays)
+{
+    auto cs = CircuitSchematic::create("half_adder_bus");
+    for (const char* bus : { "x", "y", "sum", "carry" }) {
+        cs->addWireBridge({ { bus, { STORAGE_SIZE } }, { std::string(bus) + "_bit", std::vector<size_t>(STORAGE_SIZE, 1) } });
+        cs->addExposedPort(std::string(bus) + "_0");
+    }
+    if (arrays) {
+        cs->addXorGateArray("half_sum", STORAGE_SIZE);
+        cs->addAndGateArray("half_carry", STORAGE_SIZE);
+        cs->addConnection("x_0", "half_sum_a");
+        cs->addConnection("y_0", "half_sum_b");
+        cs->addConnection("x_0", "half_carry_a");
+        cs->addConnection("y_0", "half_carry_b");
+        cs->addConnection("half_sum_c", "sum_0");
+        cs->addConnection("half_carry_c", "carry_0");
+        return cs;
+    }
+    for (size_t i = 0; i < STORAGE_SIZE; i++) {
+        const std::string bit = "_bit_" + std::to_string(i);
+        const std::string index = std::to_string(i);
+        cs->addXorGate("half_sum" + index);
+        cs->addAndGate("half_carry" + index);
+        cs->addConnection("x" + bit, "half_sum" + index + "_a");
+        cs->addConnection("y" + bit, "half_sum" + index + "_b");
+        cs->addConnection("x" + bit, "half_carry" + index + "_a");
+        cs->addConnection("y" + bit, "half_carry" + index + "_b");
+        cs->addConnection("half_sum" + index + "_c", "sum" + bit);
+        cs->addConnection("half_carry" + index + "_c", "carry" + bit);
+    }
+    return cs;
+}
+
+std::shared_ptr<CircuitSchematic> optimizedRandomDag()
+{
+    auto schematic = randomSchematic(1, 64, 4096, 64, false);
+    schematic->optimize();
+    return schematic;
+}
+
+Workload& rippleAdders()
+{
+    static Workload workload(ripple_adder, 256);
+    return workload;
+}
+
+Workload& coalescedRippleAdders()
+{
+    BuildOptions options;
+    options.coalesce_sockets = true;
+    static Workload workload(ripple_adder, 256, options);
+    return workload;
+}
+
+Workload& placedRandomDags()
+{
+    BuildOptions options;
+    options.place_gates = true;
+    static Workload workload(random_dag, 16, options);
+    return workload;
+}
+
+Workload& multipliers()
+{
+    static Workload workload(multiplier, 16);
+    return workload;
+}
+
+Workload& randomDags()
+{
+    static Workload workload(random_dag, 16);
+    return workload;
+}
+
+Workload& optimizedRandomDags()
+{
+    static auto schematic = optimizedRandomDag();
+    static Workload workload(schematic, 16);
+    return workload;
+}
+
+Workload& halfAdderBuses(bool arrays)
+{
+    static auto gates = halfAdderBus(false);
+    static auto gate_arrays = halfAdderBus(true);
+    static Workload gate_workload(gates, 1024);
+    static Workload array_workload(gate_arrays, 1024);
+    return arrays ? array_workload : gate_workload;
+}
+
+Workload& deepHierarchy()
+{
+    static Workload workload(hierarchy.back(), 1);
+    return workload;
+}
+
+/// @brief Benchmark checkpointing a workload after every tick, reporting the bytes of state covered
+void benchmarkCheckpoint(BenchmarkState& state, Workload& workload, bool incremental)
+{
+    Checkpointer checkpointer(workload.managers);
+    std::stringstream out;
+    checkpointer.save(out);
+    for (auto _ : state) {
+        state.pauseTiming();
+        workload.managers.tick();
+        out.str("");
+        state.resumeTiming();
+        incremental ? checkpointer.saveIncremental(out) : checkpointer.save(out);
+    }
+    state.setRate("bytes", workload.managers.arena->size() * sizeof(BoolStorage));
+    state.setCounter("words_written", checkpointer.getLastWordCount());
+}
+
+/// @brief Discards everything written to it
+class NullBuffer : public std::streambuf {
+protected:
+    std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+    int overflow(int c) override { return c; }
+};
+
+/// @brief Benchmark ticking a workload while tracing every named port of its circuits
+void benchmarkTracedTick(BenchmarkState& state, Workload& workload)
+{
+    NullBuffer buffer;
+    std::ostream out(&buffer);
+    WaveformRecorder recorder(out);
+    for (size_t i = 0; i < workload.circuits.size(); i++) {
+        recorder.addCircuit("c" + std::to_string(i), *workload.circuits[i]);
+    }
+    uint64_t time = 0;
+    recorder.sample(time++);
+    for (auto _ : state) {
+        workload.managers.tick();
+        recorder.sample(time++);
+    }
+    recorder.close();
+    state.setRate("gates", gateCount(workload.managers));
+    state.setCounter("signals", recorder.signalCount());
+    state.setRate("changes", static_cast<double>(recorder.getChangeCount()) / time);
+}
+
+void tick(Managers& managers) { managers.tick(); }
+void tickLevelized(Managers& managers) { managers.tickLevelized(); }
+void tickParallel(Managers& managers) { managers.tickParallel(); }
+void tickEventDriven(Managers& managers) { managers.tickEventDriven(); }
+void tickSockets(Managers& managers) { managers.socketController->tick(); }
+
+}
+
+BENCHMARK(BuildRippleAdder64) { benchmarkBuild(state, ripple_adder); }
+BENCHMARK(BuildMultiplier32) { benchmarkBuild(state, multiplier); }
+BENCHMARK(BuildRandomDag4096) { benchmarkBuild(state, random_dag); }
+BENCHMARK(BuildDeepHierarchy14) { benchmarkBuild(state, hierarchy.back()); }
+
+BENCHMARK(LoadImageMultiplier32) { benchmarkImageLoad(state, multiplier); }
+BENCHMARK(LoadImageDeepHierarchy14) { benchmarkImageLoad(state, hierarchy.back()); }
+
+BENCHMARK(TickRippleAdder64x256) { benchmarkTick(state, rippleAdders(), tick); }
+BENCHMARK(TickCoalescedRippleAdder64x256) { benchmarkTick(state, coalescedRippleAdders(), tick); }
+BENCHMARK(TickLevelizedRippleAdder64x256) { benchmarkTick(state, rippleAdders(), tickLevelized); }
+BENCHMARK(TickParallelRippleAdder64x256) { benchmarkTick(state, rippleAdders(), tickParallel); }
+BENCHMARK(TickEventDrivenRippleAdder64x256) { benchmarkTick(state, rippleAdders(), tickEventDriven); }
+BENCHMARK(TickMultiplier32x16) { benchmarkTick(state, multipliers(), tick); }
+BENCHMARK(TickRandomDag4096x16) { benchmarkTick(state, randomDags(), tick); }
+BENCHMARK(TickPlacedRandomDag4096x16) { benchmarkTick(state, placedRandomDags(), tick); }
+BENCHMARK(TickOptimizedRandomDag4096x16) { benchmarkTick(state, optimizedRandomDags(), tick); }
+BENCHMARK(TickHalfAdderBus1024) { benchmarkTick(state, halfAdderBuses(false), tick); }
+BENCHMARK(TickHalfAdderBusArrays1024) { benchmarkTick(state, halfAdderBuses(true), tick); }
+BENCHMARK(TickDeepHierarchy14) { benchmarkTick(state, deepHierarchy(), tick); }
+
+BENCHMARK(TracedTickRandomDag4096x16) { benchmarkTracedTick(state, randomDags()); }
+
+BENCHMARK(CheckpointMultiplier32x16) { benchmarkCheckpoint(state, multipliers(), false); }
+BENCHMARK(CheckpointIncrementalMultiplier32x16) { benchmarkCheckpoint(state, multipliers(), true); }
+
+BENCHMARK(SocketTickRippleAdder64x256) { benchmarkTick(state, rippleAdders(), tickSockets); }
+BENCHMARK(SocketTickCoalescedRippleAdder64x256) { benchmarkTick(state, coalescedRippleAdders(), tickSockets); }
+BENCHMARK(SocketTickRandomDag4096x16) { benchmarkTick(state, randomDags(), tickSockets); }
@@ -0,0 +1,58 @@
+#include "benchmark.hpp"
+#include "blifReader.hpp"
+#include <random>
+#include <sstream>
+
+namespace {
+
+/// @brief A random flat BLIF netlist of two input covers, like the output of a synthesis tool
+std::string randomBlif(uint64_t seed, size_t inputs, size_t gates)
+{
+    static const char* covers[] = { "11 1\n", "1- 1\n-1 1\n", "10 1\n01 1\n", "01 1\n", "11 0\n" };
+    std::mt19937_64 rng(seed);
+    std::string text = ".model random\n.inputs";
+    std::vector<std::string> nets;
+    for (size_t i = 0; i < inputs; i++) {
+        nets.push_back("in" + std::to_string(i));
+        text += " " + nets.back();
+    }
+    text += "\n.outputs n" + std::to_string(gates - 1) + "\n";
+    for (size_t i = 0; i < gates; i++) {
+        const std::string a = nets[rng() % nets.size()];
+        const std::string b = nets[rng() % nets.size()];
+        nets.push_back("n" + std::to_string(i));
+        text += ".names " + a + " " + b + " " + nets.back() + "\n" + covers[rng() % 5];
+    }
+    text += ".end\n";
+    return text;
+}
+
+const std::string netlist = randomBlif(1, 64, 100000);
+
+}
+
+BENCHMARK(ReadBlif100k)
+{
+    for (auto _ : state) {
+        state.pauseTiming();
+        std::istringstream in(netlist);
+        BlifReader reader;
+        state.resumeTiming();
+        reader.read(in);
+    }
+    state.setRate("bytes", netlist.size());
+}
+
+BENCHMARK(ReadAndBuildBlif100k)
+{
+    for (auto _ : state) {
+        state.pauseTiming();
+        std::istringstream in(netlist);
+        BlifReader reader;
+        Managers managers;
+        state.resumeTiming();
+        reader.read(in);
+        reader.getTop()->build(managers);
+    }
+    state.setRate("bytes", netlist.size());
+}
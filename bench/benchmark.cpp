@@ -0,0 +1,79 @@
+#include "benchmark.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+std::vector<std::pair<std::string, BenchmarkFunction>>& registry()
+{
+    static std::vector<std::pair<std::string, BenchmarkFunction>> benchmarks;
+    return benchmarks;
+}
+
+std::string formatValue(double value)
+{
+    const char* suffixes[] = { "", "k", "M", "G", "T" };
+    size_t suffix = 0;
+    while (value >= 1000 && suffix < 4) {
+        value /= 1000;
+        suffix++;
+    }
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.3g%s", value, suffixes[suffix]);
+    return buffer;
+}
+
+}
+
+bool registerBenchmark(std::string name, BenchmarkFunction function)
+{
+    registry().emplace_back(std::move(name), std::move(function));
+    return true;
+}
+
+void runBenchmarks(const std::string& filter, double min_seconds)
+{
+    std::printf("%-40s %14s %12s  %s\n", "Benchmark", "Time/iter", "Iterations", "Counters");
+    for (const auto& [name, function] : registry()) {
+        if (name.find(filter) == std::string::npos) {
+            continue;
+        }
+
+        // Grow the iteration count until a run takes long enough to be measured reliably
+        size_t iterations = 1;
+        while (true) {
+            BenchmarkState state(iterations);
+            function(state);
+            const double seconds = state.getSeconds();
+            if (seconds >= min_seconds || iterations >= 1000000000) {
+                std::string counters;
+                for (const auto& counter : state.getCounters()) {
+                    const double value = counter.rate ? counter.value / seconds : counter.value;
+                    counters += counter.name + "=" + formatValue(value) + (counter.rate ? "/s " : " ");
+                }
+                std::printf("%-40s %11.3f us %12zu  %s\n", name.c_str(), seconds * 1e6 / iterations, iterations, counters.c_str());
+                std::fflush(stdout);
+                break;
+            }
+            const double scale = seconds > 0 ? min_seconds * 1.4 / seconds : 10;
+            iterations = std::max(iterations + 1, static_cast<size_t>(iterations * std::min(scale, 10.0)));
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string filter;
+    double min_seconds = 0.5;
+    for (int i = 1; i < argc; i++) {
+        if (std::strncmp(argv[i], "--min-time=", 11) == 0) {
+            min_seconds = std::atof(argv[i] + 11);
+        } else {
+            filter = argv[i];
+        }
+    }
+    runBenchmarks(filter, min_seconds);
+    return 0;
+}
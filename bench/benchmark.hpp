@@ -0,0 +1,105 @@
+#include <chrono>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#pragma once
+
+/// @brief The state handed to a benchmark, modelled after Google Benchmark.
+/// The timed region is the `for (auto _ : state)` loop, anything before it is setup.
+class BenchmarkState {
+    using Clock = std::chrono::steady_clock;
+
+    size_t iterations;
+    Clock::time_point start;
+    Clock::duration elapsed {};
+    bool running = false;
+
+    struct Counter {
+        std::string name;
+        double value;
+        bool rate;
+    };
+    std::vector<Counter> counters;
+
+public:
+    explicit BenchmarkState(size_t iterations)
+        : iterations(iterations)
+    {
+    }
+
+    class Iterator {
+        BenchmarkState* state;
+        size_t remaining;
+
+    public:
+        Iterator(BenchmarkState* state, size_t remaining)
+            : state(state)
+            , remaining(remaining)
+        {
+        }
+        size_t operator*() const { return remaining; }
+        Iterator& operator++()
+        {
+            remaining--;
+            return *this;
+        }
+        bool operator!=(const Iterator&)
+        {
+            if (remaining == 0) {
+                state->pauseTiming();
+                return false;
+            }
+            return true;
+        }
+    };
+
+    Iterator begin()
+    {
+        resumeTiming();
+        return { this, iterations };
+    }
+    Iterator end() { return { this, 0 }; }
+
+    /// @brief Exclude the following code from the measured time, until resumeTiming()
+    void pauseTiming()
+    {
+        if (running) {
+            elapsed += Clock::now() - start;
+            running = false;
+        }
+    }
+
+    void resumeTiming()
+    {
+        if (!running) {
+            start = Clock::now();
+            running = true;
+        }
+    }
+
+    /// @brief Report a per second rate, given the amount processed by a single iteration
+    void setRate(std::string name, double per_iteration) { counters.push_back({ std::move(name), per_iteration * iterations, true }); }
+
+    /// @brief Report a plain value
+    void setCounter(std::string name, double value) { counters.push_back({ std::move(name), value, false }); }
+
+    size_t getIterations() const { return iterations; }
+    double getSeconds() const { return std::chrono::duration<double>(elapsed).count(); }
+    const std::vector<Counter>& getCounters() const { return counters; }
+};
+
+using BenchmarkFunction = std::function<void(BenchmarkState&)>;
+
+/// @brief Add a benchmark to the suite, used by the BENCHMARK macro
+bool registerBenchmark(std::string name, BenchmarkFunction function);
+
+/// @brief Run every benchmark whose name contains the filter
+/// @param min_seconds The time each benchmark runs for at least, the iterations are scaled to reach it
+void runBenchmarks(const std::string& filter, double min_seconds);
+
+#define BENCHMARK(name)                                                        \
+    static void name(BenchmarkState& state);                                   \
+    static const bool name##_registered = registerBenchmark(#name, name); \
+    static void name(BenchmarkState& state)
@@ -0,0 +1,164 @@
+#include "boolStorage.hpp"
+#include "managers.hpp"
+#include <bitset>
+#include <cstdint>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#pragma once
+
+/// @brief Simulates LANES independent copies of a built circuit at once.
+/// Every bit of the circuit gets its own word of LANES bits, lane i holding the value of the bit
+/// in the i-th simulation. Gates and sockets then operate on whole words, so a tick advances
+/// all simulations together. Useful for exhaustive testing and fault simulation.
+///
+/// The simulator is a snapshot of the circuit built into the managers, ticks follow the same
+/// order as Managers::tick(), and all lanes start out with the current state of the managers.
+template <size_t LANES = 64>
+class BatchSimulator {
+public:
+    using Lanes = std::bitset<LANES>;
+
+private:
+    struct BinaryOp {
+        uint32_t a;
+        uint32_t b;
+        uint32_t c;
+    };
+    struct UnaryOp {
+        uint32_t a;
+        uint32_t b;
+    };
+
+    std::unordered_map<const BoolStorage*, uint32_t> word_ids;
+    std::vector<Lanes> nodes;
+
+    std::vector<BinaryOp> and_ops;
+    std::vector<UnaryOp> not_ops;
+    std::vector<BinaryOp> or_ops;
+    std::vector<BinaryOp> xor_ops;
+    std::vector<UnaryOp> copy_ops;
+
+    uint32_t wordId(const BoolStorage* word)
+    {
+        auto [it, inserted] = word_ids.emplace(word, static_cast<uint32_t>(nodes.size() / STORAGE_SIZE));
+        if (inserted) {
+            for (size_t bit = 0; bit < STORAGE_SIZE; bit++) {
+                nodes.push_back((*word)[bit] ? Lanes().set() : Lanes());
+            }
+        }
+        return it->second;
+    }
+
+    uint32_t node(uint32_t word, size_t bit) const { return static_cast<uint32_t>(word * STORAGE_SIZE + bit); }
+
+    size_t portNode(const BoolStorageAccessor& port, size_t bit) const
+    {
+        if (bit >= port.getSocketSize()) {
+            throw std::runtime_error("Bit exceeds port size");
+        }
+        auto it = word_ids.find(port.getBuffer().get());
+        if (it == word_ids.end()) {
+            throw std::runtime_error("Port is not part of the simulated circuit");
+        }
+        return node(it->second, port.getBitOffset() + bit);
+    }
+
+    template <size_t N>
+    void addBank(DataBank<N>& bank, std::vector<BinaryOp>& ops)
+    {
+        for (size_t i = 0; i < bank.size(); i++) {
+            const uint32_t a = wordId(&bank.word(0, i)), b = wordId(&bank.word(1, i)), c = wordId(&bank.word(2, i));
+            for (size_t bit = 0; bit < bank.usedBits(i); bit++) {
+                ops.push_back({ node(a, bit), node(b, bit), node(c, bit) });
+            }
+        }
+    }
+
+public:
+    explicit BatchSimulator(Managers& managers)
+    {
+        addBank(managers.andGate->getDataBank(), and_ops);
+        DataBank<2>& not_bank = managers.notGate->getDataBank();
+        for (size_t i = 0; i < not_bank.size(); i++) {
+            const uint32_t a = wordId(&not_bank.word(0, i)), b = wordId(&not_bank.word(1, i));
+            for (size_t bit = 0; bit < not_bank.usedBits(i); bit++) {
+                not_ops.push_back({ node(a, bit), node(b, bit) });
+            }
+        }
+        addBank(managers.orGate->getDataBank(), or_ops);
+        addBank(managers.xorGate->getDataBank(), xor_ops);
+
+        DataBank<1>& random_access = *managers.random_access_data_bank;
+        for (size_t i = 0; i < random_access.size(); i++) {
+            wordId(&random_access.word(0, i));
+        }
+
+        for (const auto& transfer : managers.socketController->getPlan()) {
+            const uint32_t from = wordId(transfer.from), to = wordId(transfer.to);
+            // A transfer reads its whole source word before writing, so bits moving up within
+            // one word are copied from the top down to not read bits that were already written
+            const bool descending = transfer.from == transfer.to && transfer.shift > 0;
+            for (size_t i = 0; i < STORAGE_SIZE; i++) {
+                const size_t bit = descending ? STORAGE_SIZE - 1 - i : i;
+                if (transfer.from_mask[bit]) {
+                    copy_ops.push_back({ node(from, bit), node(to, bit + transfer.shift) });
+                }
+            }
+        }
+    }
+
+    /// @brief Advance every simulation by one tick
+    void tick()
+    {
+        for (const auto& op : and_ops) {
+            nodes[op.c] = nodes[op.a] & nodes[op.b];
+        }
+        for (const auto& op : not_ops) {
+            nodes[op.b] = ~nodes[op.a];
+        }
+        for (const auto& op : or_ops) {
+            nodes[op.c] = nodes[op.a] | nodes[op.b];
+        }
+        for (const auto& op : xor_ops) {
+            nodes[op.c] = nodes[op.a] ^ nodes[op.b];
+        }
+        for (const auto& op : copy_ops) {
+            nodes[op.b] = nodes[op.a];
+        }
+    }
+
+    /// @brief Set a bit of a port in every simulation, lane i going to simulation i
+    void setLanes(const BoolStorageAccessor& port, size_t bit, const Lanes& lanes)
+    {
+        nodes[portNode(port, bit)] = lanes;
+    }
+
+    /// @brief Get a bit of a port in every simulation, lane i coming from simulation i
+    Lanes getLanes(const BoolStorageAccessor& port, size_t bit) const
+    {
+        return nodes[portNode(port, bit)];
+    }
+
+    /// @brief Set a port of a single simulation
+    void set(const BoolStorageAccessor& port, size_t lane, BoolStorage value)
+    {
+        for (size_t bit = 0; bit < port.getSocketSize(); bit++) {
+            nodes[portNode(port, bit)].set(lane, value[bit]);
+        }
+    }
+
+    /// @brief Get a port of a single simulation
+    BoolStorage get(const BoolStorageAccessor& port, size_t lane) const
+    {
+        BoolStorage value;
+        for (size_t bit = 0; bit < port.getSocketSize(); bit++) {
+            value[bit] = nodes[portNode(port, bit)][lane];
+        }
+        return value;
+    }
+
+    /// @brief Get the amount of simulated gates in each simulation
+    size_t gateCount() const { return and_ops.size() + not_ops.size() + or_ops.size() + xor_ops.size(); }
+};
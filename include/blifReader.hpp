@@ -0,0 +1,127 @@
+#include "circuitSchematic.hpp"
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#pragma once
+
+/// @brief Reads gate level netlists in BLIF into schematics, one line at a time.
+///
+/// Only the current line and the nets of unfinished models are held in memory, so the size of
+/// the netlist is limited by the schematics it produces, not by the text. Every `.model` becomes
+/// a CircuitSchematic named after it:
+/// - `.inputs` and `.outputs` become single bit wire bridges, exposed under the net name
+/// - `.names` covers of up to 6 inputs that compute an AND, OR or XOR of their literals, or the
+///   complement of one, become trees of two input gates with NOT gates for inverted literals
+/// - `.subckt` becomes a sub-circuit named `<model>#i<index>`, models may be referenced before they are defined
+///
+/// Nets are aliases in the schematic. Everything the reader adds for them is named `<net>#...`,
+/// which no BLIF name can reach because `#` starts a comment, so nets like `x_a` or `y_0` never
+/// resolve to the ports of a gate or bridge. Gate names continue with a digit after the `#` and
+/// sub-circuit names with an `i`, so a net and a model of the same name do not meet either.
+///
+/// Sequential and library constructs (`.latch`, `.gate`) are rejected.
+class BlifReader {
+    enum class GateKind {
+        And,
+        Or,
+        Xor,
+    };
+
+    /// @brief A signal feeding a gate, either a net of the model or a port of a gate added for it
+    struct Operand {
+        std::string name;
+        bool is_port;
+    };
+
+    struct Instance {
+        std::string name;
+        std::string model;
+        std::vector<std::pair<std::string, std::string>> bindings;
+        size_t line;
+    };
+
+    /// @brief The nets of a model that is being read
+    struct Model {
+        std::string name;
+        std::shared_ptr<CircuitSchematic> schematic;
+        std::unordered_set<std::string> inputs;
+        std::unordered_set<std::string> outputs;
+        /// @brief The port driving each net
+        std::unordered_map<std::string, std::string> drivers;
+        /// @brief Nets that are a copy of another net
+        std::unordered_map<std::string, std::string> buffers;
+        /// @brief The NOT gate output of every inverted net
+        std::unordered_map<std::string, std::string> inverted;
+        /// @brief Ports waiting for the driver of a net, connected when the model is finished
+        std::vector<std::pair<std::string, std::string>> sinks;
+        /// @brief Sub-circuits of models whose ports were not known yet
+        std::vector<Instance> instances;
+        size_t gate_count = 0;
+        size_t instance_count = 0;
+    };
+
+    /// @brief The ports of a model that has been read
+    struct Interface {
+        std::unordered_set<std::string> inputs;
+        std::unordered_set<std::string> outputs;
+    };
+
+    /// @brief The `.names` block being read
+    struct Cover {
+        std::vector<std::string> nets;
+        uint64_t minterms = 0;
+        char phase = 0;
+        size_t line = 0;
+    };
+
+    std::map<std::string, std::shared_ptr<CircuitSchematic>> schematics;
+    std::unordered_map<std::string, Interface> interfaces;
+    std::vector<Model> deferred_models;
+    std::unique_ptr<Model> model;
+    std::unique_ptr<Cover> cover;
+    std::string top;
+    size_t line_number = 0;
+    size_t bytes_read = 0;
+
+    std::shared_ptr<CircuitSchematic> schematicFor(const std::string& name);
+    [[noreturn]] void fail(const std::string& message, size_t line) const;
+
+    void beginModel(const std::string& name);
+    void endModel();
+    void finishModel(Model& model);
+    void addRow(const std::vector<std::string_view>& tokens);
+    void endCover();
+    void addInstance(Model& model, const Instance& instance);
+
+    void setDriver(Model& model, const std::string& net, const std::string& port, size_t line);
+    void connect(Model& model, const Operand& source, const std::string& port);
+    Operand literal(Model& model, const std::string& net, bool negated);
+    Operand reduce(Model& model, GateKind kind, std::vector<Operand> operands, const std::string& net);
+    /// @brief Get a new gate name for a net, `<net>#<index>`
+    std::string gateName(Model& model, const std::string& net);
+    /// @brief Get the port driving a net, following buffers, or an empty string if the net is not driven yet
+    std::string findDriver(const Model& model, std::string net) const;
+
+public:
+    /// @brief Read a netlist, adding its models to the ones read before
+    void read(std::istream& in);
+
+    /// @brief Read a netlist file, see read()
+    void readFile(const std::string& path);
+
+    /// @brief Get the schematic of the first model read, throws if no model was read
+    std::shared_ptr<CircuitSchematic> getTop() const;
+
+    /// @brief Get the schematic of a model, throws if the model is unknown
+    std::shared_ptr<CircuitSchematic> getModel(const std::string& name) const;
+
+    /// @brief Get the amount of bytes read so far
+    size_t getBytesRead() const { return bytes_read; }
+};
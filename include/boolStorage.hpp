@@ -1,10 +1,19 @@
 #include <bitset>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <stdexcept>
 #pragma once
 
-constexpr size_t STORAGE_SIZE = 64;
+/// @brief The width of a storage word in bits, chosen at compile time with -DCIRCUITSIM_STORAGE_SIZE=<bits>.
+/// 64 matches a general purpose register, 128, 256 and 512 match an SSE, AVX2 and AVX-512 register,
+/// letting a single socket move and a single gate word evaluate that many bits.
+#ifndef CIRCUITSIM_STORAGE_SIZE
+#define CIRCUITSIM_STORAGE_SIZE 64
+#endif
+constexpr size_t STORAGE_SIZE = CIRCUITSIM_STORAGE_SIZE;
+static_assert(STORAGE_SIZE == 64 || STORAGE_SIZE == 128 || STORAGE_SIZE == 256 || STORAGE_SIZE == 512,
+    "CIRCUITSIM_STORAGE_SIZE must be 64, 128, 256 or 512");
 
 using BoolStorage = std::bitset<STORAGE_SIZE>;
 
@@ -148,9 +157,9 @@ const auto ONES = BoolStorage(0).flip();
 /// without having to copy the bits.
 class BoolStorageAccessor {
     /// @brief The offset of the bits in the buffer
-    size_t bit_offset;
+    uint16_t bit_offset;
     /// @brief The amount of bits this accerssor has control over
-    size_t socket_size;
+    uint16_t socket_size;
     /// @brief Reference to the shared buffer
     std::weak_ptr<BoolStorage> buffer_ref;
 
@@ -160,8 +169,8 @@ public:
     /// @param socket_size The amount of bits this accerssor has control over
     /// @param buffer Reference to the shared buffer
     BoolStorageAccessor(size_t bit_offset, size_t socket_size, std::weak_ptr<BoolStorage> buffer)
-        : bit_offset(bit_offset)
-        , socket_size(socket_size)
+        : bit_offset(static_cast<uint16_t>(bit_offset))
+        , socket_size(static_cast<uint16_t>(socket_size))
         , buffer_ref(buffer)
     {
         if (bit_offset + socket_size > STORAGE_SIZE) {
@@ -205,4 +214,7 @@ public:
 
     /// @brief Get the socket size
     size_t getSocketSize() const { return socket_size; }
+
+    /// @brief Get the shared buffer this accessor points into
+    std::shared_ptr<BoolStorage> getBuffer() const;
 };
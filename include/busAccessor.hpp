@@ -0,0 +1,66 @@
+#include "boolStorage.hpp"
+#include <memory>
+#include <vector>
+
+#pragma once
+
+/// @brief A class that provides access to a run of bits spanning any amount of consecutive words.
+/// The bus starts at a bit offset in its first word and continues through the following words,
+/// like a BoolStorageAccessor that is not limited to a single word.
+/// Values are exchanged as vectors of words, word i holding bits [i * STORAGE_SIZE, (i + 1) * STORAGE_SIZE) of the bus.
+class BusAccessor {
+    /// @brief The offset of the bits in the first word
+    size_t bit_offset;
+    /// @brief The amount of bits on the bus
+    size_t bit_count;
+    /// @brief Reference to the first word, the following words are stored right after it
+    std::weak_ptr<BoolStorage> buffer_ref;
+
+public:
+    /// @brief Construct a new BusAccessor object
+    /// @param bit_offset The offset of the bits in the first word
+    /// @param bit_count The amount of bits on the bus
+    /// @param first_word The first of the consecutive words holding the bus
+    BusAccessor(size_t bit_offset, size_t bit_count, std::weak_ptr<BoolStorage> first_word);
+
+    /// @brief Construct a bus covering the bits of a single word accessor
+    BusAccessor(const BoolStorageAccessor& accessor);
+
+    /// @brief Construct a new empty BusAccessor object
+    BusAccessor()
+        : bit_offset(0)
+        , bit_count(0)
+    {
+    }
+
+    /// @brief Get a word of the bus value
+    BoolStorage getWord(size_t index) const;
+
+    /// @brief Set a word of the bus value, leaving the other bits of the words untouched
+    void setWord(size_t index, BoolStorage value);
+
+    /// @brief Get the bus value as wordCount() words
+    std::vector<BoolStorage> get() const;
+
+    /// @brief Set the bus value, missing words are set to zero
+    void set(const std::vector<BoolStorage>& value);
+
+    bool getBit(size_t index) const;
+    void setBit(size_t index, bool value);
+
+    /// @brief Get an accessor to a run of bits of the bus, throws if the run crosses a word boundary
+    /// @param begin The first bit of the run, relative to the start of the bus
+    BoolStorageAccessor slice(size_t begin, size_t size) const;
+
+    size_t getBitOffset() const { return bit_offset; }
+    size_t getBitCount() const { return bit_count; }
+
+    /// @brief Get the amount of words in a bus value
+    size_t wordCount() const { return (bit_count + STORAGE_SIZE - 1) / STORAGE_SIZE; }
+
+    /// @brief Get the amount of storage words the bus touches
+    size_t spannedWords() const { return (bit_offset + bit_count + STORAGE_SIZE - 1) / STORAGE_SIZE; }
+
+    /// @brief Get the first word of the bus
+    std::shared_ptr<BoolStorage> getBuffer() const;
+};
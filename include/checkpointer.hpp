@@ -0,0 +1,73 @@
+#include "boolStorage.hpp"
+#include "managers.hpp"
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#pragma once
+
+/// @brief Saves and restores the complete simulation state of a Managers instance.
+///
+/// All gate banks and the random access bank draw their words from the managers' StorageArena,
+/// so a snapshot is the arena written chunk by chunk. It can be restored into managers built the
+/// same way, which is checked with a fingerprint of the bank sizes.
+///
+/// After a checkpoint the checkpointer keeps a copy of the state it wrote. An incremental
+/// checkpoint compares the arena against that copy and only writes the changed words, preceded by
+/// a bitmap of which words changed. Incremental checkpoints are restored in order on top of the
+/// full checkpoint they follow.
+///
+/// Restoring writes the arena directly, which the EventScheduler notices through its external
+/// write detection.
+class Checkpointer {
+public:
+    /// @brief Bumped whenever the layout of a checkpoint changes
+    static constexpr uint32_t VERSION = 1;
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        /// @brief Whether only the changed words follow the header
+        uint32_t incremental;
+        uint32_t storage_size;
+        uint32_t word_bytes;
+        uint64_t word_count;
+        /// @brief A fingerprint of the bank sizes of the managers
+        uint64_t layout;
+        /// @brief Identifies the full checkpoint an incremental checkpoint builds on
+        uint64_t chain;
+        /// @brief 0 for a full checkpoint, n for the n-th incremental checkpoint after it
+        uint64_t sequence;
+        /// @brief The amount of words written after the header and bitmap
+        uint64_t changed_words;
+    };
+
+private:
+    Managers& managers;
+    /// @brief The state written or restored by the last checkpoint
+    std::vector<BoolStorage> baseline;
+    uint64_t chain = 0;
+    uint64_t sequence = 0;
+    size_t last_words = 0;
+
+    uint64_t layoutFingerprint() const;
+    Header makeHeader(bool incremental) const;
+    void checkHeader(const Header& header) const;
+
+public:
+    explicit Checkpointer(Managers& managers);
+
+    /// @brief Write the whole state and start a new chain of incremental checkpoints
+    void save(std::ostream& out);
+
+    /// @brief Write the words changed since the last checkpoint, throws if there is none
+    void saveIncremental(std::ostream& out);
+
+    /// @brief Read a full checkpoint, or an incremental checkpoint that follows the last one restored.
+    /// Throws if the checkpoint was written from differently built managers or out of order.
+    void restore(std::istream& in);
+
+    /// @brief Get the amount of words written or read by the last checkpoint
+    size_t getLastWordCount() const { return last_words; }
+};
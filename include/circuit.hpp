@@ -5,9 +5,9 @@
 #include "gates/notGate.hpp"
 #include "gates/orGate.hpp"
 #include "gates/xorGate.hpp"
+#include "portTable.hpp"
 #include "socketController.hpp"
 #include "wireBridge.hpp"
-#include <map>
 #include <memory>
 #include <set>
 #include <string>
@@ -19,6 +19,7 @@ public:
     /// @brief The location where sub-circuits are stored.
     /// The public ports of the sub-circuits are stored in the bool_storage_access_map.
     std::vector<std::shared_ptr<Circuit>> sub_circuits;
-    std::map<std::string, BoolStorageAccessor> bool_storage_access_map;
-    std::map<std::string, BoolStorageAccessor> exposed_ports;
+    /// @brief All ports of the circuit by name. The names are shared with the other circuits built from the same schematic.
+    PortTable bool_storage_access_map;
+    PortTable exposed_ports;
 };
\ No newline at end of file
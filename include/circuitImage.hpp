@@ -0,0 +1,134 @@
+#include "boolStorage.hpp"
+#include "circuit.hpp"
+#include "managers.hpp"
+#include "storageArena.hpp"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#pragma once
+
+/// @brief A fully built circuit stored as a flat binary image, which is simulated straight from a memory mapping.
+///
+/// The image holds every word of the managers' StorageArena, the gate banks as runs of arena words,
+/// the compiled socket plan with arena indices instead of pointers, and a sorted table of the
+/// circuit's port names. Loading maps the file copy-on-write and points into it, so nothing is
+/// parsed or allocated per gate: a large design is ready to tick as soon as the file is mapped.
+/// Ticking and setting ports only changes the private mapping, never the file.
+///
+/// Images are tied to the storage word width they were written with. Only the header is validated
+/// on load, the records are trusted like any other build artifact.
+class CircuitImage {
+public:
+    /// @brief Bumped whenever the layout of the file changes
+    static constexpr uint32_t VERSION = 1;
+
+    /// @brief A location and element count in the file
+    struct Section {
+        uint64_t offset;
+        uint64_t count;
+    };
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        /// @brief Written as 0x01020304, detects images from machines of another byte order
+        uint32_t byte_order;
+        uint32_t storage_size;
+        uint32_t word_bytes;
+        uint64_t file_size;
+        /// @brief The arena words, index i holding arena word i
+        Section words;
+        /// @brief The runs of gate words, in the order Managers::tick() evaluates them
+        std::array<Section, 4> gates;
+        Section transfers;
+        /// @brief The ports, sorted by name
+        Section ports;
+        /// @brief The characters of the port names
+        Section names;
+    };
+
+    /// @brief A run of consecutive words of a gate bank, one arena index per dimension.
+    /// NOT gates leave `c` unused.
+    struct GateRun {
+        uint32_t a;
+        uint32_t b;
+        uint32_t c;
+        uint32_t size;
+    };
+
+    /// @brief A SocketController::Transfer with arena indices in place of pointers
+    struct Transfer {
+        BoolStorage from_mask;
+        BoolStorage keep_mask;
+        uint32_t from;
+        uint32_t to;
+        int32_t shift;
+        uint32_t whole_word;
+    };
+
+    struct Port {
+        uint32_t name_offset;
+        uint32_t name_size;
+        StorageHandle handle;
+    };
+
+private:
+    struct Mapping;
+    std::unique_ptr<Mapping> mapping;
+
+    const Header* header;
+    BoolStorage* words;
+    std::array<const GateRun*, 4> gates;
+    const Transfer* transfers;
+    const Port* ports;
+    const char* names;
+
+    std::string_view portName(const Port& port) const { return { names + port.name_offset, port.name_size }; }
+
+public:
+    /// @brief Write the circuit built into the managers to an image file.
+    /// The circuit's ports become the port table of the image, so every port has to be part of the managers.
+    static void write(const std::string& path, Managers& managers, const Circuit& circuit);
+
+    /// @brief Map an image file, throws if it is not a valid image for this build
+    explicit CircuitImage(const std::string& path);
+    CircuitImage(CircuitImage&& other) noexcept;
+    CircuitImage& operator=(CircuitImage&& other) noexcept;
+    ~CircuitImage();
+
+    /// @brief Advance the circuit by one tick, in the same order as Managers::tick()
+    void tick();
+
+    /// @brief Get the handle of a port, throws if the name is unknown
+    StorageHandle find(std::string_view name) const;
+
+    BoolStorage get(StorageHandle handle) const
+    {
+        return (words[handle.word] >> handle.bit_offset) & (ONES >> (STORAGE_SIZE - handle.size));
+    }
+
+    void set(StorageHandle handle, BoolStorage value)
+    {
+        const auto mask = ONES >> (STORAGE_SIZE - handle.size);
+        words[handle.word] &= ~(mask << handle.bit_offset);
+        words[handle.word] |= (value & mask) << handle.bit_offset;
+    }
+
+    BoolStorage get(std::string_view name) const { return get(find(name)); }
+    void set(std::string_view name, BoolStorage value) { set(find(name), value); }
+
+    /// @brief Get the amount of words of the simulated state
+    size_t wordCount() const { return header->words.count; }
+
+    /// @brief Get the amount of named ports
+    size_t portCount() const { return header->ports.count; }
+
+    /// @brief Get the name of a port by its index in the sorted port table
+    std::string_view portName(size_t index) const { return portName(ports[index]); }
+
+    /// @brief Get the amount of compiled socket transfers
+    size_t transferCount() const { return header->transfers.count; }
+};
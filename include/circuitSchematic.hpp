@@ -1,6 +1,7 @@
 #pragma once
 #include "circuit.hpp"
 #include "managers.hpp"
+#include <array>
 #include <map>
 #include <memory>
 #include <queue>
@@ -8,6 +9,25 @@
 #include <tuple>
 #include <unordered_set>
 
+/// @brief Options of CircuitSchematic::build()
+struct BuildOptions {
+    /// @brief Let wire bridge ports with a single driver share the driver's storage instead of
+    /// copying it every tick. Only ports of single view bridges are coalesced, a socket is kept
+    /// where the sizes differ or the drivers form a loop. Values reach coalesced ports within the
+    /// tick they are written, and writing a coalesced port writes its driver.
+    bool coalesce_sockets = false;
+    /// @brief Lend gates and wire bridges in breadth first order over the connections instead of
+    /// declaration order, so connected logic shares words, and add the sockets in the order of the
+    /// ports they write. Sockets then walk through memory in order, but as sockets into different
+    /// ports are reordered, a change may take a different amount of ticks to propagate.
+    bool place_gates = false;
+    /// @brief The bytes the managers may hold once the circuit is built, see MemoryReport. Counts the
+    /// bank words and sockets of the managers plus the accessors of the new circuit, the port names
+    /// belong to the schematics. build() throws before lending any storage if its estimate exceeds
+    /// the budget. 0 means no limit.
+    size_t memory_budget = 0;
+};
+
 /// @brief A class that holds the building instructions for a circuit.
 /// This class is used to build a circuit from a list of gates and wires.
 /// It does not request any memory from the data banks, and thus is copiable.
@@ -36,6 +56,16 @@ private:
     std::vector<std::string> or_gates;
     std::vector<std::string> xor_gates;
 
+    // Gate arrays by name and gate count, lent side by side in a single word
+    struct GateArray {
+        std::string name;
+        size_t size;
+    };
+    std::vector<GateArray> and_gate_arrays;
+    std::vector<GateArray> not_gate_arrays;
+    std::vector<GateArray> or_gate_arrays;
+    std::vector<GateArray> xor_gate_arrays;
+
     // A list of wire bridges. Each wire bridge is a collection of named port views.
     std::vector<Bridge> wire_bridges;
 
@@ -52,8 +82,6 @@ private:
 
     std::weak_ptr<CircuitSchematic> self;
 
-    std::tuple<std::vector<WireBridgeData>, std::vector<std::vector<std::vector<std::string>>>> generateWireBridgeData() const;
-
     std::map<std::string, std::string> aliases;
 
     /// @brief Resolves an alias to its target port. Allows for aliases of aliases.
@@ -61,6 +89,80 @@ private:
     /// @return The target port.
     std::string resolveAlias(std::string port) const;
 
+    /// @brief A relocatable description of a built circuit.
+    /// Every name of the schematic is resolved to a slot once, building an instance then only
+    /// lends storage and copies accessors into the slots.
+    struct Layout {
+        /// @brief A port of a wire bridge, at a bit offset from the start of the bridge
+        struct BridgePort {
+            uint32_t slot;
+            size_t offset;
+            size_t size;
+        };
+        struct BridgeLayout {
+            size_t width;
+            std::vector<BridgePort> ports;
+            /// @brief Whether every port can share the storage of its driver, so no storage is needed
+            bool coalescible;
+        };
+
+        /// @brief The port names of the built circuits, shared by all of them
+        std::shared_ptr<const PortLayout> ports;
+        std::shared_ptr<const PortLayout> exposed;
+        size_t and_count;
+        size_t not_count;
+        size_t or_count;
+        size_t xor_count;
+        /// @brief The slots of the gate ports, in the order the gates are lent
+        std::vector<uint32_t> gate_slots;
+        std::vector<BridgeLayout> bridges;
+        /// @brief A gate array: the slots of the ports of the whole array, followed by the slots
+        /// of the ports of every gate
+        struct GateArrayLayout {
+            size_t size;
+            std::vector<uint32_t> slots;
+        };
+        /// @brief The gate arrays of every kind, in AND, NOT, OR, XOR order
+        std::array<std::vector<GateArrayLayout>, 4> gate_arrays;
+        /// @brief The gate slots, bridge indices and connection indices in placement order, see BuildOptions::place_gates
+        std::vector<uint32_t> placed_gate_slots;
+        std::vector<uint32_t> placed_bridges;
+        std::vector<uint32_t> placed_connections;
+        /// @brief The slot pairs of the connections
+        std::vector<std::pair<uint32_t, uint32_t>> connections;
+        /// @brief The bit size of every slot
+        std::vector<size_t> slot_sizes;
+        /// @brief Wire bridge port slots that can share the storage of a driver, paired with the
+        /// slot of the driver. Drivers are never coalescible themselves.
+        std::vector<std::pair<uint32_t, uint32_t>> coalescible;
+        /// @brief Whether a connection is replaced when coalescing, by connection index
+        std::vector<bool> coalescible_connections;
+        /// @brief The slot of every exposed port in the port layout and in the exposed port layout
+        std::vector<std::pair<uint32_t, uint32_t>> exposed_slots;
+        /// @brief For every sub-circuit, the slots its exposed ports take in this circuit
+        std::vector<std::vector<uint32_t>> sub_export_slots;
+        /// @brief The revisions of the sub-circuit schematics the layout was resolved against
+        std::vector<size_t> sub_revisions;
+    };
+
+    /// @brief Counts the changes to the schematic, so parents notice changed sub-circuits
+    size_t revision = 0;
+    std::shared_ptr<const Layout> layout;
+
+    /// @brief Drop the cached layout after a change to the schematic
+    void modified();
+
+    /// @brief Get the layout of the schematic, resolving it if it is missing or outdated.
+    /// Throws if an alias, connection or exposed port refers to a missing port.
+    std::shared_ptr<const Layout> getLayout();
+
+    /// @brief Find the wire bridge ports of a layout that can share the storage of their only driver
+    void resolveCoalescing(Layout& layout) const;
+
+    /// @brief Order the gates of every kind and the wire bridges of a layout by a breadth first
+    /// walk over the connections, starting from the exposed ports, then the connections by their targets
+    static void resolvePlacement(Layout& layout);
+
 public:
     static std::shared_ptr<CircuitSchematic> create(std::string name)
     {
@@ -73,6 +175,18 @@ public:
     void addNotGate(std::string name);
     void addOrGate(std::string name);
     void addXorGate(std::string name);
+
+    /// @brief Add `count` AND gates lent side by side in a single word, at most STORAGE_SIZE.
+    /// The array has the `count` bit ports `name_a`, `name_b` and `name_c`, which connect to a
+    /// bus of the same size with a single word transfer. Gate `i` of the array also has the
+    /// single bit ports `name_i_a`, `name_i_b` and `name_i_c`.
+    void addAndGateArray(std::string name, size_t count);
+    /// @brief Add an array of NOT gates, with the ports `name_a` and `name_b`, see addAndGateArray()
+    void addNotGateArray(std::string name, size_t count);
+    /// @brief Add an array of OR gates, see addAndGateArray()
+    void addOrGateArray(std::string name, size_t count);
+    /// @brief Add an array of XOR gates, see addAndGateArray()
+    void addXorGateArray(std::string name, size_t count);
     void addWireBridge(Bridge wire_bridge);
     void addSubCircuit(std::string name, std::weak_ptr<CircuitSchematic> schematic);
     void addConnection(std::string from, std::string to);
@@ -80,9 +194,33 @@ public:
     void addAlias(std::string target_port, std::string alias);
 
 private:
-    std::shared_ptr<Circuit> earlyGenerate();
-    void lateGenerate(std::shared_ptr<Circuit> circuit, Managers& managers, std::shared_ptr<Circuit> parent, std::string name_in_parent);
+    static std::shared_ptr<Circuit> earlyGenerate(const Layout& layout, const Managers& managers);
+    /// @brief Replays the lends of a build on the free bits of a data bank, counting the words it adds
+    struct BankEstimate;
+    /// @brief Add the lends of a layout to the data banks, in Managers order, and the bytes of its sockets and port handles
+    static void estimateBuild(const Layout& layout, const BuildOptions& options, std::array<BankEstimate, 5>& banks, size_t& bytes);
+    static void lateGenerate(Circuit& circuit, const Layout& layout, Managers& managers, Circuit* parent, const std::vector<uint32_t>* export_slots, const BuildOptions& options);
 
 public:
-    std::shared_ptr<Circuit> build(Managers& managers);
+    std::shared_ptr<Circuit> build(Managers& managers, const BuildOptions& options = {});
+
+    /// @brief The parts optimize() removed from the schematics
+    struct OptimizationStats {
+        size_t removed_gates = 0;
+        size_t removed_bridges = 0;
+        size_t removed_connections = 0;
+    };
+
+    /// @brief Simplify this schematic and the schematics of its sub-circuits in place.
+    /// Removes gates and wire bridges that can not affect an exposed port, collapses NOT-NOT
+    /// chains, folds constants (undriven ports read as 0), merges gates computing the same function
+    /// of the same signals and lets connections read through single view bridges.
+    /// Every schematic is optimized against its own exposed ports, so sub-circuits stay shared.
+    /// Gate arrays and the logic they read are kept as they are.
+    /// The settled values of the exposed ports are preserved, the amount of ticks a change takes to
+    /// propagate is not. Unexposed ports of removed parts disappear from built circuits.
+    OptimizationStats optimize();
+
+private:
+    OptimizationStats optimizeSchematic();
 };
\ No newline at end of file
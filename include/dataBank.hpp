@@ -1,100 +1,297 @@
 #include "boolStorage.hpp"
+#include "busAccessor.hpp"
+#include "storageArena.hpp"
 #include <array>
 #include <cstddef>
 #include <memory>
 #include <stdexcept>
+#include <utility>
 #include <vector>
 
 #pragma once
 
 /// @brief A high storage dynamic array made for delegating storage to StorageAccessors. No
 /// Only allocations are tracked, so shrinking the array is not possible.
+///
+/// Storage is kept as a structure of arrays: every dimension owns its own contiguous chunks of
+/// words, and word `i` of every dimension belongs to the same lent block. The chunks never move,
+/// so accessors can keep referencing them while the bank grows.
+/// The chunks are drawn from a StorageArena, which can be shared with other banks.
 template <size_t N>
 class DataBank {
-    struct StorageData {
-        std::shared_ptr<BoolStorage> storage;
-        // The offset of the first free bit, ranging from 0 to STORAGE_SIZE
-        // If all bits are used, this will be STORAGE_SIZE
-        size_t free_bit_offset;
-    };
-    std::vector<std::array<StorageData, N>> storage;
+public:
+    /// @brief The amount of words allocated at once for each dimension
+    static constexpr size_t CHUNK_SIZE = StorageArena::CHUNK_SIZE;
+
+    /// @brief A contiguous run of words, one pointer per dimension
+    using Span = std::array<BoolStorage*, N>;
+
+private:
+    std::shared_ptr<StorageArena> arena;
+    // The chunks of each dimension, chunk i of every dimension covers the same words
+    std::array<std::vector<BoolStorage*>, N> chunks;
+    // The arena index of the first word of every chunk
+    std::array<std::vector<uint32_t>, N> chunk_words;
+    // The offset of the first free bit of each word, ranging from 0 to STORAGE_SIZE
+    // If all bits are used, this will be STORAGE_SIZE
+    std::vector<size_t> free_bit_offsets;
+    // The words with free bits left, grouped by their amount of free bits
+    std::array<std::vector<size_t>, STORAGE_SIZE + 1> open_words;
+
+    /// @brief Appends a new word to every dimension and returns its index
+    size_t allocateWord(size_t used_bits)
+    {
+        const size_t index = free_bit_offsets.size();
+        if (index % CHUNK_SIZE == 0) {
+            for (size_t i = 0; i < N; i++) {
+                const uint32_t first_word = arena->allocateChunk();
+                chunk_words[i].push_back(first_word);
+                chunks[i].push_back(&arena->word(first_word));
+            }
+        }
+        free_bit_offsets.push_back(used_bits);
+        if (used_bits < STORAGE_SIZE) {
+            open_words[STORAGE_SIZE - used_bits].push_back(index);
+        }
+        return index;
+    }
+
+    /// @brief Reserves bit_count bits in a word of every dimension
+    /// @return The index of the word and the offset of the bits
+    std::pair<size_t, size_t> reserveBits(size_t bit_count)
+    {
+        if (bit_count > STORAGE_SIZE) {
+            throw std::runtime_error("Requested bit_count exceeds STORAGE_SIZE");
+        }
+        // find the fullest storage block with enough space
+        size_t free_bits = bit_count > 0 ? bit_count : 1;
+        while (free_bits <= STORAGE_SIZE && open_words[free_bits].empty()) {
+            free_bits++;
+        }
+
+        size_t index;
+        if (free_bits > STORAGE_SIZE) {
+            // if no storage block was found, create a new one
+            index = allocateWord(0);
+            open_words[STORAGE_SIZE].pop_back();
+            free_bits = STORAGE_SIZE;
+        } else {
+            index = open_words[free_bits].back();
+            open_words[free_bits].pop_back();
+        }
+        const size_t bit_offset = free_bit_offsets[index];
+        free_bit_offsets[index] += bit_count;
+        if (free_bits - bit_count > 0) {
+            open_words[free_bits - bit_count].push_back(index);
+        }
+        return { index, bit_offset };
+    }
+
+    /// @brief Returns a shared pointer to a single word that shares ownership of its chunk
+    std::shared_ptr<BoolStorage> sharedWord(size_t dimension, size_t index) const
+    {
+        return std::shared_ptr<BoolStorage>(arena->getChunk(wordIndex(dimension, index)), chunks[dimension][index / CHUNK_SIZE] + index % CHUNK_SIZE);
+    }
 
 public:
+    /// @brief Create a bank with an arena of its own
+    DataBank()
+        : arena(std::make_shared<StorageArena>())
+    {
+    }
+
+    /// @brief Create a bank drawing its words from a shared arena
+    explicit DataBank(std::shared_ptr<StorageArena> arena)
+        : arena(arena)
+    {
+    }
+
+    StorageArena& getArena() { return *arena; }
+
     /// @brief  Lends N BoolStorageAccessors from the storage.
     /// They are guarenteed to be at the same offset and bit_count.
+    /// Words are picked best fit from lists grouped by free bit count, so lending takes
+    /// constant time regardless of how many words the bank holds.
     /// @param bit_count
     /// @return
     std::array<BoolStorageAccessor, N> lendBools(size_t bit_count)
     {
-        if (bit_count > STORAGE_SIZE) {
-            throw std::runtime_error("Requested bit_count exceeds STORAGE_SIZE");
+        const auto [index, bit_offset] = reserveBits(bit_count);
+        std::array<BoolStorageAccessor, N> accessors;
+        for (size_t i = 0; i < N; i++) {
+            accessors[i] = BoolStorageAccessor(bit_offset, bit_count, sharedWord(i, index));
         }
-        // find first storage block with enough space
-        for (std::array<StorageData, N>& storage_block : storage) {
-            if (storage_block[0].free_bit_offset + bit_count <= STORAGE_SIZE) {
+        return accessors;
+    }
 
-                std::array<BoolStorageAccessor, N> accessors;
+    /// @brief Lends `count` groups of N BoolStorageAccessors at once, see lendBools(size_t).
+    std::vector<std::array<BoolStorageAccessor, N>> lendBools(size_t count, size_t bit_count)
+    {
+        std::vector<std::array<BoolStorageAccessor, N>> result;
+        result.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            result.push_back(lendBools(bit_count));
+        }
+        return result;
+    }
 
-                for (size_t i = 0; i < N; i++) {
-                    accessors[i] = BoolStorageAccessor(storage_block[i].free_bit_offset, bit_count, storage_block[i].storage);
-                }
+    /// @brief Lends the bits of lendBools(size_t) as handles into the arena
+    std::array<StorageHandle, N> lendHandles(size_t bit_count)
+    {
+        const auto [index, bit_offset] = reserveBits(bit_count);
+        std::array<StorageHandle, N> handles;
+        for (size_t i = 0; i < N; i++) {
+            handles[i] = { wordIndex(i, index), static_cast<uint16_t>(bit_offset), static_cast<uint16_t>(bit_count) };
+        }
+        return handles;
+    }
 
-                for (size_t i = 0; i < N; i++) {
-                    storage_block[i].free_bit_offset += bit_count;
-                }
-                return accessors;
-            }
+    /// @brief Lends `count` groups of N handles at once, see lendHandles(size_t).
+    std::vector<std::array<StorageHandle, N>> lendHandles(size_t count, size_t bit_count)
+    {
+        std::vector<std::array<StorageHandle, N>> result;
+        result.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            result.push_back(lendHandles(bit_count));
         }
+        return result;
+    }
 
-        // if no storage block was found, create a new one
-        std::array<StorageData, N> new_storage_block;
-        std::array<BoolStorageAccessor, N> accessors;
+    /// @brief Lends N buses of bit_count bits, spanning as many consecutive words as needed.
+    /// The words of a bus lie in a single chunk, so at most CHUNK_SIZE words can be lent at once.
+    /// Bits left over in the last word stay available to lendBools().
+    std::array<BusAccessor, N> lendBus(size_t bit_count)
+    {
+        const size_t word_count = bit_count > 0 ? (bit_count + STORAGE_SIZE - 1) / STORAGE_SIZE : 1;
+        if (word_count > CHUNK_SIZE) {
+            throw std::runtime_error("Requested bus exceeds CHUNK_SIZE words");
+        }
+        // Skip to the next chunk if the bus does not fit in the current one, the skipped words stay open
+        while (size() % CHUNK_SIZE != 0 && size() % CHUNK_SIZE + word_count > CHUNK_SIZE) {
+            allocateWord(0);
+        }
+        const size_t first = size();
+        for (size_t i = 0; i + 1 < word_count; i++) {
+            allocateWord(STORAGE_SIZE);
+        }
+        allocateWord(bit_count - (word_count - 1) * STORAGE_SIZE);
+
+        std::array<BusAccessor, N> buses;
         for (size_t i = 0; i < N; i++) {
-            new_storage_block[i].storage = std::make_shared<BoolStorage>();
-            new_storage_block[i].free_bit_offset = bit_count;
-            accessors[i] = BoolStorageAccessor(0, bit_count, new_storage_block[i].storage);
+            buses[i] = BusAccessor(0, bit_count, sharedWord(i, first));
         }
-        storage.emplace_back(new_storage_block);
-        return accessors;
+        return buses;
     }
 
     std::array<std::weak_ptr<BoolStorage>, N> lendStorage()
     {
-        std::array<StorageData, N> new_storage_block;
+        // mark all bits as used since we are lending the whole storage
+        const size_t index = allocateWord(STORAGE_SIZE);
         std::array<std::weak_ptr<BoolStorage>, N> accessors;
         for (size_t i = 0; i < N; i++) {
-            new_storage_block[i].storage = std::make_shared<BoolStorage>();
-            // mark all bits as used since we are lending the whole storage
-            new_storage_block[i].free_bit_offset = STORAGE_SIZE;
-            accessors[i] = new_storage_block[i].storage;
+            accessors[i] = sharedWord(i, index);
         }
-        storage.emplace_back(new_storage_block);
         return accessors;
     }
 
     /// @brief Clear all bits in the storage, not the storage itself
     void clear()
     {
-        for (std::array<StorageData, N>& storage_block : storage) {
-            for (size_t i = 0; i < N; i++) {
-                StorageData& data = storage_block[i];
-                BoolStorage& storage = *data.storage;
-                storage.reset();
+        for (std::vector<BoolStorage*>& dimension : chunks) {
+            for (BoolStorage* chunk : dimension) {
+                for (size_t i = 0; i < CHUNK_SIZE; i++) {
+                    chunk[i].reset();
+                }
             }
         }
     }
 
+    /// @brief Bit utilization of the bank, counted over all dimensions
+    struct Usage {
+        size_t words;
+        size_t bits_used;
+        size_t bits_allocated;
+    };
+
+    /// @brief Get how many of the allocated bits are lent out
+    Usage getUsage() const
+    {
+        Usage usage { size(), 0, size() * STORAGE_SIZE * N };
+        for (size_t used : free_bit_offsets) {
+            usage.bits_used += used * N;
+        }
+        return usage;
+    }
+
+    /// @brief Get the bytes of bookkeeping held by the bank, its words are counted by the arena
+    size_t metadataBytes() const
+    {
+        size_t bytes = free_bit_offsets.capacity() * sizeof(size_t);
+        for (size_t i = 0; i < N; i++) {
+            bytes += chunks[i].capacity() * sizeof(BoolStorage*) + chunk_words[i].capacity() * sizeof(uint32_t);
+        }
+        for (const auto& words : open_words) {
+            bytes += words.capacity() * sizeof(size_t);
+        }
+        return bytes;
+    }
+
+    /// @brief Get the amount of words lent out in every dimension
+    size_t size() const { return free_bit_offsets.size(); }
+
+    /// @brief Get the amount of bits lent out of a word, starting from bit 0
+    size_t usedBits(size_t index) const { return free_bit_offsets[index]; }
+
+    /// @brief Get the amount of words with exactly free_bits bits left to lend
+    size_t openWords(size_t free_bits) const { return open_words[free_bits].size(); }
+
+    /// @brief Get a word of the given dimension
+    BoolStorage& word(size_t dimension, size_t index) { return chunks[dimension][index / CHUNK_SIZE][index % CHUNK_SIZE]; }
+
+    /// @brief Get the index of a word of the given dimension in the arena
+    uint32_t wordIndex(size_t dimension, size_t index) const { return chunk_words[dimension][index / CHUNK_SIZE] + static_cast<uint32_t>(index % CHUNK_SIZE); }
+
+    /// @brief Get the amount of contiguous runs of lent words
+    size_t spanCount() const { return (size() + CHUNK_SIZE - 1) / CHUNK_SIZE; }
+
+    /// @brief Get a contiguous run of lent words
+    Span span(size_t index) const
+    {
+        Span result;
+        for (size_t i = 0; i < N; i++) {
+            result[i] = chunks[i][index];
+        }
+        return result;
+    }
+
+    /// @brief Get the amount of lent words in a contiguous run
+    size_t spanSize(size_t index) const
+    {
+        const size_t remaining = size() - index * CHUNK_SIZE;
+        return remaining < CHUNK_SIZE ? remaining : CHUNK_SIZE;
+    }
+
+    /// @brief Calls `f(span, size)` for every contiguous run of lent words.
+    /// No allocations or reference count updates are made, which makes it suitable for ticking.
+    template <typename F>
+    void forEachSpan(F&& f)
+    {
+        for (size_t i = 0; i < spanCount(); i++) {
+            f(span(i), spanSize(i));
+        }
+    }
+
     std::vector<std::array<std::weak_ptr<BoolStorage>, N>> getStorage()
     {
         std::vector<std::array<std::weak_ptr<BoolStorage>, N>> result;
-        result.reserve(storage.size());
-        for (std::array<StorageData, N>& storage_block : storage) {
+        result.reserve(size());
+        for (size_t index = 0; index < size(); index++) {
             std::array<std::weak_ptr<BoolStorage>, N> block;
             for (size_t i = 0; i < N; i++) {
-                block[i] = storage_block[i].storage;
+                block[i] = sharedWord(i, index);
             }
             result.push_back(block);
         }
         return result;
     };
-};
\ No newline at end of file
+};
@@ -0,0 +1,102 @@
+#include "boolStorage.hpp"
+#include "socketController.hpp"
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+#pragma once
+
+struct Managers;
+
+/// @brief Ticks a circuit by only re-evaluating the gate words and socket transfers whose
+/// input words changed since they were last evaluated.
+/// The resulting state is bit-identical to Managers::tick().
+///
+/// Words written by the engine are tracked directly. Writes made from outside the engine
+/// (e.g. through exposed ports) are found by comparing every word against a shadow copy at the
+/// start of a tick, unless external write detection is disabled and the writes are reported
+/// through notifyWrite().
+class EventScheduler {
+public:
+    /// @brief The amount of work done during a tick
+    struct Activity {
+        size_t gate_words = 0;
+        size_t transfers = 0;
+    };
+
+    /// @brief Tick the circuit held by the managers.
+    /// The scheduler is rebuilt whenever gates or sockets were added since the previous tick.
+    void tick(Managers& managers);
+
+    /// @brief Report a write made through an accessor outside of the engine
+    void notifyWrite(const BoolStorageAccessor& accessor);
+
+    /// @brief Enable or disable scanning for writes made outside of the engine
+    void setExternalWriteDetection(bool enabled) { detect_external_writes = enabled; }
+
+    /// @brief Get the amount of work done during the last tick
+    const Activity& getLastActivity() const { return activity; }
+
+private:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    enum class GateKind : uint8_t {
+        And,
+        Not,
+        Or,
+        Xor,
+    };
+
+    /// @brief A single gate bank word, NOT gates leave b equal to a
+    struct GateOp {
+        GateKind kind;
+        uint32_t a;
+        uint32_t b;
+        uint32_t c;
+    };
+
+    /// @brief Where in the tick a word changed
+    enum class Phase {
+        External,
+        Gates,
+        Sockets,
+    };
+
+    // Used to notice structural changes to the circuit
+    std::vector<size_t> signature;
+
+    std::vector<BoolStorage*> words;
+    std::vector<BoolStorage> shadow;
+    std::unordered_map<const BoolStorage*, uint32_t> word_ids;
+
+    std::vector<GateOp> gate_ops;
+    // The gate op reading or writing each word, if any
+    std::vector<uint32_t> word_gate;
+
+    std::vector<SocketController::Transfer> transfers;
+    std::vector<uint32_t> transfer_from;
+    std::vector<uint32_t> transfer_to;
+    // The transfers reading each word (as source or as preserved destination bits), in plan order
+    std::vector<uint32_t> reader_offsets;
+    std::vector<uint32_t> readers;
+
+    std::vector<char> gate_pending;
+    std::vector<uint32_t> gate_queue;
+    std::vector<uint32_t> gate_work;
+    std::vector<char> transfer_now;
+    std::vector<char> transfer_next;
+    std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<uint32_t>> transfer_heap;
+    std::vector<uint32_t> transfer_queue_next;
+
+    bool detect_external_writes = true;
+    Activity activity;
+
+    std::vector<size_t> computeSignature(Managers& managers) const;
+    void compile(Managers& managers);
+    uint32_t wordId(BoolStorage* word);
+    void wordChanged(uint32_t word, Phase phase, uint32_t source);
+    void scheduleGate(uint32_t gate);
+    void evaluateGate(uint32_t gate);
+};
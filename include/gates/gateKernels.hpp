@@ -0,0 +1,36 @@
+#include "boolStorage.hpp"
+#include <cstddef>
+
+#pragma once
+
+/// @brief The instruction sets the gate kernels can be dispatched to.
+enum class KernelIsa {
+    Scalar,
+    Avx2,
+    Avx512,
+};
+
+/// @brief Get the best instruction set supported by the running CPU
+KernelIsa detectKernelIsa();
+
+/// @brief Get the instruction set the gate kernels currently dispatch to.
+/// Defaults to the result of detectKernelIsa().
+KernelIsa getKernelIsa();
+
+/// @brief Force the gate kernels to use the given instruction set.
+/// Throws if the running CPU does not support it. Safe to call while other threads tick,
+/// every kernel call uses either the previous or the new instruction set.
+/// @param isa The instruction set to use
+void setKernelIsa(KernelIsa isa);
+
+/// @brief c[i] = a[i] & b[i] for every word in the spans
+void andKernel(const BoolStorage* a, const BoolStorage* b, BoolStorage* c, size_t size);
+
+/// @brief c[i] = a[i] | b[i] for every word in the spans
+void orKernel(const BoolStorage* a, const BoolStorage* b, BoolStorage* c, size_t size);
+
+/// @brief c[i] = a[i] ^ b[i] for every word in the spans
+void xorKernel(const BoolStorage* a, const BoolStorage* b, BoolStorage* c, size_t size);
+
+/// @brief b[i] = ~a[i] for every word in the spans
+void notKernel(const BoolStorage* a, BoolStorage* b, size_t size);
@@ -1,5 +1,7 @@
 #include "boolStorage.hpp"
 #include "dataBank.hpp"
+#include "gateKernels.hpp"
+#include "instrumentation.hpp"
 #include "socketController.hpp"
 #include "wireBridge.hpp"
 
@@ -7,26 +9,76 @@
 
 class XorGate {
     DataBank<3> db;
+    PhaseStats stats;
 
 public:
+    XorGate() = default;
+
+    /// @brief Create the gate manager with its storage drawn from a shared arena
+    explicit XorGate(std::shared_ptr<StorageArena> arena)
+        : db(arena)
+    {
+    }
+
     std::array<BoolStorageAccessor, 3> lendGate()
     {
         return db.lendBools(1);
     }
 
+    /// @brief Lend several gates at once
+    std::vector<std::array<BoolStorageAccessor, 3>> lendGates(size_t count)
+    {
+        return db.lendBools(count, 1);
+    }
+
+    /// @brief Lend several gates at once, as handles into the arena
+    std::vector<std::array<StorageHandle, 3>> lendGateHandles(size_t count)
+    {
+        return db.lendHandles(count, 1);
+    }
+
+    /// @brief Lend `count` gates side by side in a single word. The ports are returned as
+    /// accessors of `count` bits, so a bus connects to all gates with a single transfer.
+    std::array<BoolStorageAccessor, 3> lendGateArray(size_t count)
+    {
+        return db.lendBools(count);
+    }
+
+    /// @brief Lend a gate array like lendGateArray(), as handles into the arena
+    std::array<StorageHandle, 3> lendGateArrayHandles(size_t count)
+    {
+        return db.lendHandles(count);
+    }
+
+    /// @brief Get the data bank holding the gate's inputs and outputs
+    DataBank<3>& getDataBank() { return db; }
+
+    /// @brief Get the counters of tick(), only updated when built with CIRCUITSIM_INSTRUMENTATION
+    const PhaseStats& getStats() const { return stats; }
+
+    /// @brief Get the amount of spans that can be ticked independently
+    size_t spanCount() const { return db.spanCount(); }
+
+    /// @brief Perform the XOR operation on a single contiguous span of the data bank
+    void tickSpan(size_t index)
+    {
+        auto [a, b, c] = db.span(index);
+        xorKernel(a, b, c, db.spanSize(index));
+    }
+
+    /// @brief Evaluate a single word of the data bank
+    void tickWord(size_t index)
+    {
+        db.word(2, index) = db.word(0, index) ^ db.word(1, index);
+    }
+
     void tick()
     {
-        // Iterate over the data bank's storage and perform the AND operation on each storage
-        auto storage_arr = db.getStorage();
-        for (auto& storage : storage_arr) {
-            auto [a, b, c] = storage;
-            auto a_lock = a.lock();
-            auto b_lock = b.lock();
-            auto c_lock = c.lock();
-            if (!a_lock || !b_lock || !c_lock) {
-                throw std::runtime_error("Failed to lock storage");
-            }
-            *c_lock = *a_lock ^ *b_lock;
+        CIRCUITSIM_INSTRUMENT(PhaseTimer timer(stats);)
+        // Perform the XOR operation on every word of the data bank, one contiguous span at a time
+        for (size_t i = 0; i < spanCount(); i++) {
+            CIRCUITSIM_INSTRUMENT(WordChanges changes(stats, db.span(i)[2], db.spanSize(i));)
+            tickSpan(i);
         }
     }
 };
@@ -0,0 +1,156 @@
+#include "boolStorage.hpp"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <ostream>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#pragma once
+
+/// @brief Instrumentation of the simulation hot paths, enabled by defining CIRCUITSIM_INSTRUMENTATION.
+/// Code wrapped in CIRCUITSIM_INSTRUMENT() is removed entirely when instrumentation is disabled,
+/// so the counters stay at zero and cost nothing.
+#ifdef CIRCUITSIM_INSTRUMENTATION
+#define CIRCUITSIM_INSTRUMENT(...) __VA_ARGS__
+constexpr bool INSTRUMENTATION_ENABLED = true;
+#else
+#define CIRCUITSIM_INSTRUMENT(...)
+constexpr bool INSTRUMENTATION_ENABLED = false;
+#endif
+
+/// @brief Read a cheap, monotonic cycle counter. Falls back to nanoseconds where no cycle counter is available.
+inline uint64_t readCycleCounter()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+/// @brief Counters of one phase of a tick, accumulated over all ticks
+struct PhaseStats {
+    uint64_t cycles = 0;
+    /// @brief Gate words evaluated, or transfers applied for the socket phase
+    uint64_t words = 0;
+    /// @brief Output bits that changed value
+    uint64_t bits_changed = 0;
+
+    PhaseStats& operator+=(const PhaseStats& other);
+    PhaseStats operator-(const PhaseStats& other) const;
+};
+
+/// @brief Adds the cycles of its lifetime to a phase
+class PhaseTimer {
+    PhaseStats& stats;
+    uint64_t start;
+
+public:
+    explicit PhaseTimer(PhaseStats& stats)
+        : stats(stats)
+        , start(readCycleCounter())
+    {
+    }
+    ~PhaseTimer() { stats.cycles += readCycleCounter() - start; }
+};
+
+/// @brief Counts the bits of a run of words that change during its lifetime.
+/// Runs of words must not overlap the run of another live WordChanges on the same thread.
+class WordChanges {
+    PhaseStats& stats;
+    const BoolStorage* words;
+    size_t count;
+
+    static std::vector<BoolStorage>& before()
+    {
+        static thread_local std::vector<BoolStorage> words;
+        return words;
+    }
+
+public:
+    WordChanges(PhaseStats& stats, const BoolStorage* words, size_t count)
+        : stats(stats)
+        , words(words)
+        , count(count)
+    {
+        before().assign(words, words + count);
+    }
+    ~WordChanges()
+    {
+        stats.words += count;
+        for (size_t i = 0; i < count; i++) {
+            stats.bits_changed += (before()[i] ^ words[i]).count();
+        }
+    }
+};
+
+/// @brief Count a dereference of a BoolStorageAccessor's buffer
+void countAccessorLock();
+
+/// @brief Get the amount of BoolStorageAccessor buffer dereferences by all threads
+uint64_t getAccessorLockCount();
+
+/// @brief The phases of Managers::tick(), in order
+enum class TickPhase {
+    AndGates,
+    NotGates,
+    OrGates,
+    XorGates,
+    Sockets,
+};
+
+constexpr size_t TICK_PHASE_COUNT = 5;
+
+/// @brief The counters of a single tick, or of several ticks added together
+struct TickStats {
+    /// @brief The number of the tick, or the amount of ticks for totals
+    uint64_t tick = 0;
+    /// @brief The cycles spent in the whole tick
+    uint64_t cycles = 0;
+    uint64_t accessor_locks = 0;
+    std::array<PhaseStats, TICK_PHASE_COUNT> phases {};
+
+    const PhaseStats& phase(TickPhase phase) const { return phases[static_cast<size_t>(phase)]; }
+};
+
+/// @brief Records the counters of every phase of Managers::tick() as a time series.
+/// Only the most recent ticks are kept, see setCapacity().
+class Instrumentation {
+public:
+    /// @brief The counters of the phases, in TickPhase order
+    using PhaseSources = std::array<const PhaseStats*, TICK_PHASE_COUNT>;
+
+private:
+    std::deque<TickStats> series;
+    size_t capacity = 1 << 16;
+    TickStats totals;
+
+    uint64_t tick_start = 0;
+    uint64_t locks_start = 0;
+    std::array<PhaseStats, TICK_PHASE_COUNT> phases_start {};
+
+public:
+    void beginTick(const PhaseSources& phases);
+    void endTick(const PhaseSources& phases);
+
+    /// @brief Get the counters of all ticks recorded since the last clear()
+    const TickStats& getTotals() const { return totals; }
+
+    /// @brief Get the counters of the most recent ticks, oldest first
+    const std::deque<TickStats>& getSeries() const { return series; }
+
+    /// @brief Set the amount of ticks kept in the series, dropping the oldest ones
+    void setCapacity(size_t capacity);
+
+    void clear();
+
+    /// @brief Write the series as CSV, one row per tick
+    void writeCsv(std::ostream& out) const;
+
+    /// @brief Write the totals and the series as a JSON object
+    void writeJson(std::ostream& out) const;
+};
@@ -0,0 +1,42 @@
+#include "socketController.hpp"
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#pragma once
+
+struct Managers;
+
+/// @brief Settles a combinational circuit in a single pass.
+/// The socket graph is analysed bit by bit to give every gate a logic depth, after which the
+/// gate words and transfers are evaluated level by level. A gate word holding gates of several
+/// levels is evaluated once per level, which is harmless as evaluation only depends on the inputs.
+///
+/// For loop-free circuits where every bit has a single driver, one tick produces the state
+/// that repeated Managers::tick() calls converge to.
+/// Combinational loops make tick() throw.
+class LevelizedScheduler {
+    /// @brief The work done for a single logic level
+    struct Stage {
+        /// @brief The words to evaluate in the and, not, or and xor banks
+        std::array<std::vector<uint32_t>, 4> gate_words;
+        /// @brief The transfers to apply afterwards, in dependency order
+        std::vector<uint32_t> transfers;
+    };
+
+    // Used to notice structural changes to the circuit
+    std::vector<size_t> signature;
+    std::vector<SocketController::Transfer> transfers;
+    std::vector<Stage> stages;
+
+    std::vector<size_t> computeSignature(Managers& managers) const;
+    void compile(Managers& managers);
+
+public:
+    /// @brief Evaluate every logic level of the circuit once
+    void tick(Managers& managers);
+
+    /// @brief Get the deepest logic level of the circuit, compiling it first if needed
+    size_t getDepth(Managers& managers);
+};
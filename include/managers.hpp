@@ -1,25 +1,66 @@
 #pragma once
 #include "dataBank.hpp"
+#include "eventScheduler.hpp"
 #include "gates/andGate.hpp"
 #include "gates/notGate.hpp"
 #include "gates/orGate.hpp"
 #include "gates/xorGate.hpp"
+#include "instrumentation.hpp"
+#include "levelizedScheduler.hpp"
+#include "parallelScheduler.hpp"
 #include "socketController.hpp"
+#include "storageArena.hpp"
 
 struct Managers {
-    std::shared_ptr<DataBank<1>> random_access_data_bank = std::make_shared<DataBank<1>>();
-    std::shared_ptr<AndGate> andGate = std::make_shared<AndGate>();
-    std::shared_ptr<NotGate> notGate = std::make_shared<NotGate>();
-    std::shared_ptr<OrGate> orGate = std::make_shared<OrGate>();
-    std::shared_ptr<XorGate> xorGate = std::make_shared<XorGate>();
+    /// @brief The storage of all data banks below, see StorageArena::handle() for compact access to ports
+    std::shared_ptr<StorageArena> arena = std::make_shared<StorageArena>();
+    std::shared_ptr<DataBank<1>> random_access_data_bank = std::make_shared<DataBank<1>>(arena);
+    std::shared_ptr<AndGate> andGate = std::make_shared<AndGate>(arena);
+    std::shared_ptr<NotGate> notGate = std::make_shared<NotGate>(arena);
+    std::shared_ptr<OrGate> orGate = std::make_shared<OrGate>(arena);
+    std::shared_ptr<XorGate> xorGate = std::make_shared<XorGate>(arena);
     std::shared_ptr<SocketController> socketController = std::make_shared<SocketController>();
+    std::shared_ptr<EventScheduler> eventScheduler = std::make_shared<EventScheduler>();
+    std::shared_ptr<ParallelScheduler> parallelScheduler = std::make_shared<ParallelScheduler>();
+    std::shared_ptr<LevelizedScheduler> levelizedScheduler = std::make_shared<LevelizedScheduler>();
+    /// @brief Per tick counters of tick(), only recorded when built with CIRCUITSIM_INSTRUMENTATION
+    std::shared_ptr<Instrumentation> instrumentation = std::make_shared<Instrumentation>();
 
     void tick()
     {
+        CIRCUITSIM_INSTRUMENT(instrumentation->beginTick(phaseStats());)
         andGate->tick();
         notGate->tick();
         orGate->tick();
         xorGate->tick();
         socketController->tick();
+        CIRCUITSIM_INSTRUMENT(instrumentation->endTick(phaseStats());)
+    }
+
+    /// @brief Get the counters of the phases of tick(), in TickPhase order
+    Instrumentation::PhaseSources phaseStats() const
+    {
+        return { &andGate->getStats(), &notGate->getStats(), &orGate->getStats(), &xorGate->getStats(), &socketController->getStats() };
+    }
+
+    /// @brief Tick only the parts of the circuit whose inputs changed since the previous tick.
+    /// Produces the same state as tick().
+    void tickEventDriven()
+    {
+        eventScheduler->tick(*this);
+    }
+
+    /// @brief Tick the circuit on multiple threads, see ParallelScheduler::setThreadCount().
+    /// Produces the same state as tick().
+    void tickParallel()
+    {
+        parallelScheduler->tick(*this);
+    }
+
+    /// @brief Settle the whole combinational circuit in a single pass, evaluating gates by logic depth.
+    /// Throws if the circuit contains a combinational loop.
+    void tickLevelized()
+    {
+        levelizedScheduler->tick(*this);
     }
 };
\ No newline at end of file
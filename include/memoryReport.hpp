@@ -0,0 +1,49 @@
+#include "circuit.hpp"
+#include "managers.hpp"
+#include <cstddef>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#pragma once
+
+/// @brief An account of the heap memory held by managers and the circuits built into them, in bytes.
+/// The sizes follow the capacities of the containers involved. Allocator overhead and the
+/// compiled schedules of the tick modes are not counted.
+class MemoryReport {
+public:
+    /// @brief The bit utilization of a data bank
+    struct BankUsage {
+        std::string name;
+        size_t words;
+        size_t bits_used;
+        size_t bits_allocated;
+    };
+
+    /// @brief The words of the arena, shared by all data banks
+    size_t bank_words = 0;
+    /// @brief The bookkeeping of the arena and the data banks, including the chunk control blocks
+    size_t bank_metadata = 0;
+    /// @brief The sockets and their compiled transfer plan
+    size_t sockets = 0;
+    /// @brief The storage handles and accessors of the port tables of the circuits
+    size_t accessors = 0;
+    /// @brief The port names of the circuits, every layout shared by circuits counts once
+    size_t names = 0;
+    /// @brief The circuit objects and their lists of sub-circuits
+    size_t circuits = 0;
+    /// @brief The data banks, in the order of the Managers members
+    std::vector<BankUsage> banks;
+
+    /// @brief Account the storage and sockets of managers, which do not know the circuits built into them
+    explicit MemoryReport(const Managers& managers);
+
+    /// @brief Add a circuit and its sub-circuits to the report.
+    /// Layouts shared with circuits added before are not counted again.
+    void addCircuit(const Circuit& circuit);
+
+    size_t total() const { return bank_words + bank_metadata + sockets + accessors + names + circuits; }
+
+private:
+    std::unordered_set<const PortLayout*> counted_layouts;
+};
@@ -0,0 +1,44 @@
+#include "socketController.hpp"
+#include "workerPool.hpp"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#pragma once
+
+struct Managers;
+
+/// @brief Ticks a circuit on a pool of worker threads.
+/// The gate phase is split into independent spans of the gate banks. The socket phase is split
+/// into groups of transfers that share no storage words, each group keeping its plan order.
+/// A barrier separates both phases, so the result is identical to Managers::tick().
+class ParallelScheduler {
+    /// @brief A span of one of the gate banks
+    struct GateTask {
+        uint8_t bank;
+        size_t span;
+    };
+
+    size_t thread_count = std::thread::hardware_concurrency();
+    std::unique_ptr<WorkerPool> pool;
+
+    // Used to notice structural changes to the circuit
+    std::vector<size_t> signature;
+    std::vector<GateTask> gate_tasks;
+    std::vector<std::vector<SocketController::Transfer>> socket_groups;
+
+    std::vector<size_t> computeSignature(Managers& managers) const;
+    void compile(Managers& managers);
+
+public:
+    /// @brief Set the amount of threads used to tick, including the calling thread
+    void setThreadCount(size_t threads);
+
+    /// @brief Get the amount of threads used to tick
+    size_t getThreadCount() const { return thread_count; }
+
+    /// @brief Get the amount of independent socket groups, at most one per thread
+    size_t getSocketGroupCount() const { return socket_groups.size(); }
+
+    void tick(Managers& managers);
+};
@@ -0,0 +1,147 @@
+#include "boolStorage.hpp"
+#include "storageArena.hpp"
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#pragma once
+
+/// @brief An interned table of port names, each mapped to a slot index.
+/// Several names can share a slot (aliases). A layout is built once per schematic and shared by
+/// every circuit built from it, so the names are stored only once.
+class PortLayout {
+    // Names are kept in a deque so the views used as map keys stay valid
+    std::deque<std::string> names;
+    std::vector<uint32_t> name_slots;
+    std::unordered_map<std::string_view, uint32_t> name_ids;
+    uint32_t slot_count = 0;
+
+public:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    PortLayout() = default;
+    PortLayout(const PortLayout& other);
+    PortLayout& operator=(const PortLayout& other);
+
+    /// @brief Add a name with a slot of its own. Existing names keep their slot.
+    /// @return The slot of the name
+    uint32_t add(const std::string& name);
+
+    /// @brief Make a name refer to an existing slot, adding the name if needed
+    void alias(const std::string& name, uint32_t slot);
+
+    /// @brief Get the slot of a name, or NONE if the name is unknown
+    uint32_t find(std::string_view name) const;
+
+    /// @brief Get the amount of names
+    size_t size() const { return names.size(); }
+
+    /// @brief Get the amount of slots
+    size_t slotCount() const { return slot_count; }
+
+    /// @brief Estimate the bytes held by the names and their lookup table
+    size_t memoryBytes() const;
+
+    /// @brief Get a name by its insertion index
+    const std::string& nameAt(size_t index) const { return names[index]; }
+
+    /// @brief Get the slot of a name by its insertion index
+    uint32_t slotAt(size_t index) const { return name_slots[index]; }
+};
+
+/// @brief The ports of a circuit: a shared PortLayout and a flat array of storage handles indexed by slot.
+/// Offers the lookup interface of a std::map from names to accessors.
+///
+/// Ports in the arena are stored as 8-byte StorageHandles and turned into accessors when they are
+/// looked up. Ports on words outside the arena keep their accessor, as do ports handed out by
+/// reference through operator[], so that the reference stays valid and writes to it are kept.
+class PortTable {
+    std::shared_ptr<const PortLayout> layout;
+    /// @brief The private copy of the layout once names were added, the same object as layout
+    std::shared_ptr<PortLayout> own_layout;
+    /// @brief The arena the handles index into, only used while arena_ref has not expired
+    StorageArena* arena = nullptr;
+    std::weak_ptr<StorageArena> arena_ref;
+    std::vector<StorageHandle> handles;
+    /// @brief Accessors that take the place of the handle of their slot
+    std::unordered_map<uint32_t, BoolStorageAccessor> accessors;
+
+    static constexpr StorageHandle EMPTY { StorageArena::NONE, 0, 0 };
+
+    BoolStorageAccessor materialize(StorageHandle handle) const;
+
+    template <typename Table>
+    class Iterator {
+        Table* table;
+        size_t index;
+
+    public:
+        Iterator(Table* table, size_t index)
+            : table(table)
+            , index(index)
+        {
+        }
+        std::pair<const std::string&, BoolStorageAccessor> operator*() const
+        {
+            return { table->layout->nameAt(index), table->slot(table->layout->slotAt(index)) };
+        }
+        Iterator& operator++()
+        {
+            index++;
+            return *this;
+        }
+        bool operator==(const Iterator& other) const { return index == other.index; }
+        bool operator!=(const Iterator& other) const { return index != other.index; }
+    };
+
+public:
+    using iterator = Iterator<PortTable>;
+    using const_iterator = Iterator<const PortTable>;
+
+    PortTable();
+    /// @brief Create a table for the slots of a layout, storing the ports in the arena as handles
+    explicit PortTable(std::shared_ptr<const PortLayout> layout, const std::shared_ptr<StorageArena>& arena = nullptr);
+
+    /// @brief Get the accessor of a name, adding the name if it is unknown
+    BoolStorageAccessor& operator[](const std::string& name);
+
+    /// @brief Get the accessor of a name, throws if the name is unknown
+    BoolStorageAccessor at(std::string_view name) const;
+
+    /// @brief Get the accessor of a slot
+    BoolStorageAccessor slot(uint32_t slot) const;
+
+    /// @brief Set the bits of a slot
+    void setSlot(uint32_t slot, const BoolStorageAccessor& accessor);
+
+    /// @brief Set the bits of a slot to bits of the table's arena
+    void setSlot(uint32_t slot, StorageHandle handle);
+
+    /// @brief Set a slot to the bits of a slot of another table, without an accessor in between
+    /// when both tables use the same arena
+    void copySlot(uint32_t slot, const PortTable& source, uint32_t source_slot);
+
+    /// @brief Get the slot of a name, or PortLayout::NONE if the name is unknown
+    uint32_t find(std::string_view name) const { return layout->find(name); }
+
+    /// @brief Get the amount of names with this name (0 or 1)
+    size_t count(std::string_view name) const { return find(name) != PortLayout::NONE; }
+
+    /// @brief Get the amount of names
+    size_t size() const { return layout->size(); }
+
+    const PortLayout& getLayout() const { return *layout; }
+
+    /// @brief Estimate the bytes of the handles and accessors, the layout is shared and counted separately
+    size_t accessorBytes() const;
+
+    iterator begin() { return { this, 0 }; }
+    iterator end() { return { this, size() }; }
+    const_iterator begin() const { return { this, 0 }; }
+    const_iterator end() const { return { this, size() }; }
+};
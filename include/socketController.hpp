@@ -1,4 +1,8 @@
 #include "boolStorage.hpp"
+#include "busAccessor.hpp"
+#include "instrumentation.hpp"
+#include "storageArena.hpp"
+#include <memory>
 #include <vector>
 
 #pragma once
@@ -24,12 +28,92 @@ public:
         {
             to.set(from.get());
         }
+
+        const BoolStorageAccessor& getFrom() const { return from; }
+        const BoolStorageAccessor& getTo() const { return to; }
+    };
+
+    /// @brief A precompiled bit transfer between two storage words.
+    /// Consecutive sockets between the same pair of words are merged into a single transfer.
+    struct Transfer {
+        /// @brief The word the bits are read from
+        BoolStorage* from;
+        /// @brief The word the bits are written to
+        BoolStorage* to;
+        /// @brief The bits read from the source word, before shifting
+        BoolStorage from_mask;
+        /// @brief The bits of the destination word that are left untouched
+        BoolStorage keep_mask;
+        /// @brief How far the bits move, positive values move towards the most significant bit
+        int shift;
+        /// @brief Whether the transfer copies a whole word as is
+        bool whole_word;
+
+        void apply() const
+        {
+            if (whole_word) {
+                *to = *from;
+                return;
+            }
+            const BoolStorage bits = *from & from_mask;
+            *to &= keep_mask;
+            *to |= shift >= 0 ? bits << shift : bits >> -shift;
+        }
     };
 
 private:
     std::vector<Socket> sockets;
 
+    /// @brief The compiled transfer plan, rebuilt whenever sockets are added
+    std::vector<Transfer> plan;
+    /// @brief Keeps the words referenced by the plan alive
+    std::vector<std::shared_ptr<BoolStorage>> plan_storage;
+    bool plan_compiled = true;
+    PhaseStats stats;
+
 public:
     void addSocket(BoolStorageAccessor from, BoolStorageAccessor to);
+
+    /// @brief Connect two buses of equal size, which may span several words.
+    /// The buses are split at the word boundaries of both sides into single word sockets, so an
+    /// aligned bus compiles into whole word copies and an unaligned one into two masked transfers per word.
+    void addSocket(const BusAccessor& from, const BusAccessor& to);
+
+    /// @brief Compile the sockets into a flat transfer plan.
+    /// Called automatically by tick() when sockets were added since the last compilation.
+    void compile();
+
+    /// @brief Get the compiled transfer plan, compiling it first if needed
+    const std::vector<Transfer>& getPlan();
+
+    /// @brief Get the bytes held by the sockets and the compiled transfer plan
+    size_t memoryBytes() const
+    {
+        return sockets.capacity() * sizeof(Socket) + plan.capacity() * sizeof(Transfer)
+            + plan_storage.capacity() * sizeof(std::shared_ptr<BoolStorage>);
+    }
+
+    /// @brief Get the sockets in the order they were added
+    const std::vector<Socket>& getSockets() const { return sockets; }
+
+    /// @brief How far apart in an arena the words touched by the sockets are, in words
+    struct Locality {
+        /// @brief The average distance between the source and the destination of a socket.
+        /// The inputs and outputs of a gate bank lie in different chunks, which puts sockets
+        /// between gates about StorageArena::CHUNK_SIZE words apart at best.
+        double distance;
+        /// @brief The average distance between the sources, and between the destinations, of
+        /// consecutive sockets. Small strides keep tick() walking through cached words.
+        double stride;
+    };
+
+    /// @brief Measure the locality of the sockets as laid out in an arena, see BuildOptions::place_gates.
+    /// Sockets with words outside the arena are not counted.
+    Locality getLocality(const StorageArena& arena) const;
+
+    /// @brief Get the counters of tick(), only updated when built with CIRCUITSIM_INSTRUMENTATION.
+    /// Every applied transfer counts as one word.
+    const PhaseStats& getStats() const { return stats; }
+
     void tick();
-};
\ No newline at end of file
+};
@@ -0,0 +1,99 @@
+#include "boolStorage.hpp"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+#pragma once
+
+/// @brief A compact reference to a run of bits in a word of a StorageArena.
+/// Plain data, so it can be copied and stored freely. Dereferencing it through the arena is a
+/// direct array index without reference counting or lifetime checks.
+struct StorageHandle {
+    /// @brief The index of the word in the arena
+    uint32_t word;
+    uint16_t bit_offset;
+    uint16_t size;
+};
+
+static_assert(sizeof(StorageHandle) == 8, "StorageHandle should stay 8 bytes");
+
+/// @brief Storage for the words of several data banks, addressed by a 32 bit word index.
+/// Words are allocated in fixed size chunks that never move, word `i` lives in chunk
+/// `i / CHUNK_SIZE`. Finding a word therefore costs two loads, while pointers and accessors
+/// into the arena stay valid as it grows.
+class StorageArena {
+public:
+    /// @brief The amount of words in a chunk, a power of two
+    static constexpr size_t CHUNK_SIZE = 256;
+
+private:
+    static constexpr size_t CHUNK_SHIFT = 8;
+    static constexpr size_t CHUNK_ALIGNMENT = 64;
+    static_assert(size_t(1) << CHUNK_SHIFT == CHUNK_SIZE, "CHUNK_SHIFT does not match CHUNK_SIZE");
+
+    std::vector<std::shared_ptr<BoolStorage[]>> chunks;
+    // The first word of every chunk, used for indexing without touching the reference counts
+    std::vector<BoolStorage*> chunk_words;
+    // Chunk indices by address of their first word, used to turn pointers into indices
+    std::map<const BoolStorage*, uint32_t> chunk_ids;
+
+public:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    /// @brief Allocate a chunk of cleared words
+    /// @return The index of the first word of the chunk
+    uint32_t allocateChunk();
+
+    /// @brief Get the chunk holding a word, for sharing ownership of the word
+    const std::shared_ptr<BoolStorage[]>& getChunk(uint32_t word) const { return chunks[word >> CHUNK_SHIFT]; }
+
+    /// @brief Get the amount of words in the arena
+    size_t size() const { return chunks.size() * CHUNK_SIZE; }
+
+    /// @brief Get the bytes of the words in the arena
+    size_t wordBytes() const { return size() * sizeof(BoolStorage); }
+
+    /// @brief Estimate the bytes of bookkeeping held by the arena: the chunk tables and the
+    /// shared_ptr control block of every chunk
+    size_t metadataBytes() const;
+
+    BoolStorage& word(uint32_t index) { return chunk_words[index >> CHUNK_SHIFT][index & (CHUNK_SIZE - 1)]; }
+    const BoolStorage& word(uint32_t index) const { return chunk_words[index >> CHUNK_SHIFT][index & (CHUNK_SIZE - 1)]; }
+
+    /// @brief Get the index of a word in the arena, or NONE if the word is not part of the arena
+    uint32_t wordIndex(const BoolStorage* word) const;
+
+    /// @brief Get a handle to the bits of an accessor, throws if they are not part of the arena
+    StorageHandle handle(const BoolStorageAccessor& accessor) const;
+
+    BoolStorage get(StorageHandle handle) const
+    {
+        return (word(handle.word) >> handle.bit_offset) & (ONES >> (STORAGE_SIZE - handle.size));
+    }
+
+    void set(StorageHandle handle, BoolStorage value)
+    {
+        const auto mask = ONES >> (STORAGE_SIZE - handle.size);
+        BoolStorage& target = word(handle.word);
+        target &= ~(mask << handle.bit_offset);
+        target |= (value & mask) << handle.bit_offset;
+    }
+
+    void clear(StorageHandle handle)
+    {
+        word(handle.word) &= ~((ONES >> (STORAGE_SIZE - handle.size)) << handle.bit_offset);
+    }
+
+    /// @brief Add (bitwise OR) a value to the bits of a handle
+    void add(StorageHandle handle, BoolStorage value)
+    {
+        word(handle.word) |= (value & (ONES >> (STORAGE_SIZE - handle.size))) << handle.bit_offset;
+    }
+
+    /// @brief "Multiply" (bitwise AND) a value to the word of a handle, like BoolStorageAccessor::multiply()
+    void multiply(StorageHandle handle, BoolStorage value)
+    {
+        word(handle.word) &= (value & (ONES >> (STORAGE_SIZE - handle.size))) << handle.bit_offset;
+    }
+};
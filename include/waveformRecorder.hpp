@@ -0,0 +1,114 @@
+#include "boolStorage.hpp"
+#include "circuit.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#pragma once
+
+/// @brief Traces ports over time into a VCD (Value Change Dump) file.
+///
+/// The traced ports are grouped by the storage word they live in. sample() compares every word
+/// against its value at the previous sample and only looks at the ports of words that changed,
+/// so a quiet circuit costs a single XOR per word. Changed values are handed to a background
+/// thread in batches, which formats and writes them, keeping the text output off the tick path.
+/// The sampling thread only blocks when the writer falls far behind.
+class WaveformRecorder {
+    /// @brief A traced run of bits, shared by every port name referring to it
+    struct Signal {
+        uint32_t word;
+        uint16_t bit_offset;
+        uint16_t size;
+        /// @brief The bits of the word belonging to the signal
+        BoolStorage mask;
+        /// @brief The VCD identifier code
+        std::string id;
+    };
+
+    struct Name {
+        std::string name;
+        uint32_t signal;
+    };
+
+    /// @brief A changed value, or the start of a timestamp when signal is TIME
+    struct Change {
+        uint32_t signal;
+        uint64_t time;
+        BoolStorage value;
+    };
+
+    static constexpr uint32_t TIME = UINT32_MAX;
+    static constexpr size_t BATCH_SIZE = 4096;
+    static constexpr size_t MAX_QUEUED_BATCHES = 64;
+
+    std::ostream& out;
+    std::string timescale;
+    std::vector<std::string> scopes;
+    // The port names of every scope
+    std::vector<std::vector<Name>> scope_names;
+    std::vector<Signal> signals;
+    // Signals by word and bit range, so ports sharing storage share a signal
+    std::unordered_map<uint64_t, uint32_t> signal_ids;
+
+    std::unordered_map<const BoolStorage*, uint32_t> word_ids;
+    std::vector<const BoolStorage*> words;
+    std::vector<BoolStorage> previous;
+    std::vector<std::vector<uint32_t>> word_signals;
+    // Keeps the traced words alive
+    std::vector<std::shared_ptr<BoolStorage>> storage;
+
+    bool started = false;
+    bool closed = false;
+    uint64_t last_time = 0;
+    size_t change_count = 0;
+    std::vector<Change> batch;
+
+    // Shared with the writer thread
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable queued_condition;
+    std::condition_variable drained_condition;
+    std::vector<std::vector<Change>> queue;
+    bool stopping = false;
+
+    void writerLoop();
+    void writeHeader();
+    void writeChanges(const std::vector<Change>& changes, std::string& text) const;
+    void submit();
+
+public:
+    /// @brief Create a recorder writing to a stream, which has to outlive the recorder
+    /// @param timescale The duration of a time unit, e.g. "1ns"
+    explicit WaveformRecorder(std::ostream& out, std::string timescale = "1ns");
+    ~WaveformRecorder();
+
+    WaveformRecorder(const WaveformRecorder&) = delete;
+    WaveformRecorder& operator=(const WaveformRecorder&) = delete;
+
+    /// @brief Trace a port, throws if sampling already started
+    /// @param scope The module the port is listed under
+    void addPort(const std::string& scope, const std::string& name, const BoolStorageAccessor& port);
+
+    /// @brief Trace every named port of a circuit under a single scope.
+    /// The names include the ports sub-circuits expose to the circuit.
+    void addCircuit(const std::string& scope, const Circuit& circuit);
+
+    /// @brief Record the values of the traced ports at a point in time.
+    /// The first sample records every value, later samples only the changed ones.
+    void sample(uint64_t time);
+
+    /// @brief Write the remaining changes and stop the writer thread. Called by the destructor.
+    void close();
+
+    /// @brief Get the amount of traced runs of bits, ports sharing storage count once
+    size_t signalCount() const { return signals.size(); }
+
+    /// @brief Get the amount of value changes recorded so far, including the initial values
+    size_t getChangeCount() const { return change_count; }
+};
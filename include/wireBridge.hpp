@@ -11,10 +11,14 @@ using WireBridgeView = std::vector<size_t>;
 /// @brief A bridge is just a collection of views or a vector of port vectors
 using WireBridgeData = std::vector<WireBridgeView>;
 
+/// @brief Get the amount of bits a bridge takes up in its word, throws if a view exceeds STORAGE_SIZE
+size_t wireBridgeWidth(const WireBridgeData& ports);
+
 /// @brief Given a DataBank and a list of ports, this function will generate differently
 /// sized BoolStorageAccessors for each port. The BoolStorageAccessors will be of the same
 /// size as the port's size.
 /// Ports cannot be larger than STORAGE_SIZE.
+/// All views alias the same bits, and the bridge is packed into a shared word of the DataBank.
 /// @param ports A list of ports, where each port is a list of sizes. (sum up to STORAGE_SIZE)
 /// @return A vector of ports, where each port is a vector of BoolStorageAccessors.
 std::vector<std::vector<BoolStorageAccessor>> wireBridge(DataBank<1>& db, const WireBridgeData& ports);
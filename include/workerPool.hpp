@@ -0,0 +1,52 @@
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#pragma once
+
+/// @brief A persistent pool of threads executing batches of indexed tasks.
+/// The calling thread takes part in every batch, and run() returns once all tasks of the batch
+/// are done, so consecutive batches are separated by a barrier.
+class WorkerPool {
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable start_condition;
+    std::condition_variable done_condition;
+    // Incremented for every batch, wakes the workers
+    size_t generation = 0;
+    size_t busy_workers = 0;
+    bool stopping = false;
+
+    // The current batch
+    void (*invoke)(void*, size_t) = nullptr;
+    void* context = nullptr;
+    size_t task_count = 0;
+    std::atomic<size_t> next_task { 0 };
+
+    void workerLoop();
+    void runTasks();
+    void runBatch(void (*batch_invoke)(void*, size_t), void* batch_context, size_t batch_task_count);
+
+public:
+    /// @brief Create a pool with the given amount of threads, including the calling thread
+    /// @param thread_count The total amount of threads executing tasks, at least 1
+    explicit WorkerPool(size_t thread_count);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /// @brief Get the total amount of threads executing tasks
+    size_t threadCount() const { return workers.size() + 1; }
+
+    /// @brief Call `f(i)` for every i in [0, count) across the pool and wait for all calls to finish
+    template <typename F>
+    void run(size_t count, F&& f)
+    {
+        runBatch([](void* ctx, size_t index) { (*static_cast<F*>(ctx))(index); }, &f, count);
+    }
+};
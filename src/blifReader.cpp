@@ -0,0 +1,476 @@
+#include "blifReader.hpp"
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+constexpr size_t MAX_COVER_INPUTS = 6;
+constexpr size_t READ_BUFFER_SIZE = 1 << 20;
+
+void tokenize(const std::string& line, std::vector<std::string_view>& tokens)
+{
+    tokens.clear();
+    size_t i = 0;
+    while (i < line.size()) {
+        while (i < line.size() && (line[i] == ' ' || line[i] == '\t' || line[i] == '\r')) {
+            i++;
+        }
+        const size_t begin = i;
+        while (i < line.size() && line[i] != ' ' && line[i] != '\t' && line[i] != '\r') {
+            i++;
+        }
+        if (i > begin) {
+            tokens.emplace_back(line.data() + begin, i - begin);
+        }
+    }
+}
+
+int popcount(uint64_t value)
+{
+    return __builtin_popcountll(value);
+}
+
+}
+
+std::shared_ptr<CircuitSchematic> BlifReader::schematicFor(const std::string& name)
+{
+    auto& schematic = schematics[name];
+    if (!schematic) {
+        schematic = CircuitSchematic::create(name);
+    }
+    return schematic;
+}
+
+void BlifReader::fail(const std::string& message, size_t line) const
+{
+    throw std::runtime_error("BLIF line " + std::to_string(line) + ": " + message);
+}
+
+void BlifReader::read(std::istream& in)
+{
+    std::string line;
+    std::string continued;
+    std::vector<std::string_view> tokens;
+    line_number = 0;
+
+    while (std::getline(in, line)) {
+        line_number++;
+        bytes_read += line.size() + 1;
+        const size_t comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.resize(comment);
+        }
+        while (!line.empty() && (line.back() == '\r' || line.back() == ' ' || line.back() == '\t')) {
+            line.pop_back();
+        }
+        if (!line.empty() && line.back() == '\\') {
+            line.back() = ' ';
+            continued += line;
+            continue;
+        }
+        if (!continued.empty()) {
+            line.insert(0, continued);
+            continued.clear();
+        }
+        tokenize(line, tokens);
+        if (tokens.empty()) {
+            continue;
+        }
+
+        if (tokens[0][0] != '.') {
+            if (!cover) {
+                fail("Unexpected line outside of a .names block", line_number);
+            }
+            addRow(tokens);
+            continue;
+        }
+        if (cover) {
+            endCover();
+        }
+
+        const std::string_view directive = tokens[0];
+        if (directive == ".model") {
+            if (model) {
+                endModel();
+            }
+            beginModel(tokens.size() > 1 ? std::string(tokens[1]) : std::string("unnamed"));
+            continue;
+        }
+        if (directive == ".end") {
+            if (model) {
+                endModel();
+            }
+            continue;
+        }
+        if (!model) {
+            // Netlists without a .model line describe a single unnamed model
+            beginModel("unnamed");
+        }
+        if (directive == ".inputs") {
+            for (size_t i = 1; i < tokens.size(); i++) {
+                const std::string net(tokens[i]);
+                model->inputs.insert(net);
+                model->schematic->addWireBridge({ { net + "#io", { 1 } } });
+                model->schematic->addAlias(net + "#io_0", net);
+                model->schematic->addExposedPort(net);
+                setDriver(*model, net, net + "#io_0", line_number);
+            }
+        } else if (directive == ".outputs") {
+            for (size_t i = 1; i < tokens.size(); i++) {
+                const std::string net(tokens[i]);
+                model->outputs.insert(net);
+                // Inputs that are also outputs are exposed already
+                if (model->inputs.count(net)) {
+                    continue;
+                }
+                model->schematic->addWireBridge({ { net + "#io", { 1 } } });
+                model->schematic->addAlias(net + "#io_0", net);
+                model->schematic->addExposedPort(net);
+                connect(*model, { net, false }, net + "#io_0");
+            }
+        } else if (directive == ".names") {
+            if (tokens.size() < 2) {
+                fail(".names without an output", line_number);
+            }
+            if (tokens.size() - 2 > MAX_COVER_INPUTS) {
+                fail("Covers of more than " + std::to_string(MAX_COVER_INPUTS) + " inputs are not supported", line_number);
+            }
+            cover = std::make_unique<Cover>();
+            cover->line = line_number;
+            for (size_t i = 1; i < tokens.size(); i++) {
+                cover->nets.emplace_back(tokens[i]);
+            }
+        } else if (directive == ".subckt") {
+            if (tokens.size() < 2) {
+                fail(".subckt without a model", line_number);
+            }
+            Instance instance { "", std::string(tokens[1]), {}, line_number };
+            instance.name = instance.model + "#i" + std::to_string(model->instance_count++);
+            for (size_t i = 2; i < tokens.size(); i++) {
+                const size_t equals = tokens[i].find('=');
+                if (equals == std::string_view::npos) {
+                    fail("Expected formal=actual in .subckt", line_number);
+                }
+                instance.bindings.emplace_back(tokens[i].substr(0, equals), tokens[i].substr(equals + 1));
+            }
+            if (interfaces.count(instance.model)) {
+                addInstance(*model, instance);
+            } else {
+                model->instances.push_back(std::move(instance));
+            }
+        } else {
+            fail("Unsupported BLIF construct " + std::string(directive), line_number);
+        }
+    }
+
+    if (cover) {
+        endCover();
+    }
+    if (model) {
+        endModel();
+    }
+    // Models that instantiate models defined further down the file
+    for (auto& deferred : deferred_models) {
+        finishModel(deferred);
+    }
+    deferred_models.clear();
+}
+
+void BlifReader::readFile(const std::string& path)
+{
+    std::vector<char> buffer(READ_BUFFER_SIZE);
+    std::ifstream in;
+    in.rdbuf()->pubsetbuf(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    in.open(path);
+    if (!in) {
+        throw std::runtime_error("Could not open " + path);
+    }
+    read(in);
+}
+
+std::shared_ptr<CircuitSchematic> BlifReader::getTop() const
+{
+    if (top.empty()) {
+        throw std::runtime_error("No model was read");
+    }
+    return getModel(top);
+}
+
+std::shared_ptr<CircuitSchematic> BlifReader::getModel(const std::string& name) const
+{
+    auto it = schematics.find(name);
+    if (it == schematics.end() || !interfaces.count(name)) {
+        throw std::runtime_error("Unknown model " + name);
+    }
+    return it->second;
+}
+
+void BlifReader::beginModel(const std::string& name)
+{
+    if (interfaces.count(name)) {
+        fail("Model " + name + " is defined twice", line_number);
+    }
+    if (top.empty()) {
+        top = name;
+    }
+    model = std::make_unique<Model>();
+    model->name = name;
+    model->schematic = schematicFor(name);
+}
+
+void BlifReader::endModel()
+{
+    if (cover) {
+        endCover();
+    }
+    interfaces[model->name] = { model->inputs, model->outputs };
+    bool ready = true;
+    for (const auto& instance : model->instances) {
+        ready = ready && interfaces.count(instance.model);
+    }
+    if (ready) {
+        finishModel(*model);
+    } else {
+        deferred_models.push_back(std::move(*model));
+    }
+    model.reset();
+}
+
+void BlifReader::finishModel(Model& model)
+{
+    for (const auto& instance : model.instances) {
+        addInstance(model, instance);
+    }
+    model.instances.clear();
+    for (const auto& [net, port] : model.sinks) {
+        const std::string driver = findDriver(model, net);
+        if (driver.empty()) {
+            throw std::runtime_error("Net " + net + " is not driven in model " + model.name);
+        }
+        model.schematic->addConnection(driver, port);
+    }
+    model.sinks.clear();
+}
+
+void BlifReader::addRow(const std::vector<std::string_view>& tokens)
+{
+    const size_t input_count = cover->nets.size() - 1;
+    const std::string_view pattern = input_count > 0 ? tokens[0] : std::string_view();
+    const std::string_view output = input_count > 0 ? (tokens.size() > 1 ? tokens[1] : std::string_view()) : tokens[0];
+    if (tokens.size() != (input_count > 0 ? 2 : 1) || pattern.size() != input_count || output.size() != 1 || (output[0] != '0' && output[0] != '1')) {
+        fail("Malformed cover row", line_number);
+    }
+    if (cover->phase != 0 && cover->phase != output[0]) {
+        fail("Cover rows mix on-set and off-set", line_number);
+    }
+    for (char c : pattern) {
+        if (c != '-' && c != '0' && c != '1') {
+            fail("Malformed cover row", line_number);
+        }
+    }
+    cover->phase = output[0];
+
+    for (uint64_t minterm = 0; minterm < (uint64_t(1) << input_count); minterm++) {
+        bool matches = true;
+        for (size_t i = 0; i < input_count && matches; i++) {
+            const bool bit = (minterm >> i) & 1;
+            matches = pattern[i] == '-' || (pattern[i] == '1') == bit;
+        }
+        if (matches) {
+            cover->minterms |= uint64_t(1) << minterm;
+        }
+    }
+}
+
+void BlifReader::endCover()
+{
+    auto current = std::move(cover);
+    const std::string out = current->nets.back();
+    std::vector<std::string> inputs(current->nets.begin(), current->nets.end() - 1);
+    auto maskOf = [](size_t input_count) { return input_count == MAX_COVER_INPUTS ? ~uint64_t(0) : (uint64_t(1) << (uint64_t(1) << input_count)) - 1; };
+    // Rows with a 0 output list where the function is false
+    uint64_t function = current->phase == '0' ? ~current->minterms & maskOf(inputs.size()) : current->minterms;
+
+    // Drop the inputs the function does not depend on
+    for (size_t i = 0; i < inputs.size();) {
+        uint64_t low = 0, high = 0;
+        for (uint64_t minterm = 0; minterm < (uint64_t(1) << inputs.size()); minterm++) {
+            const uint64_t rest = (minterm & ((uint64_t(1) << i) - 1)) | ((minterm >> (i + 1)) << i);
+            ((minterm >> i) & 1 ? high : low) |= ((function >> minterm) & 1) << rest;
+        }
+        if (low == high) {
+            function = low;
+            inputs.erase(inputs.begin() + static_cast<std::ptrdiff_t>(i));
+        } else {
+            i++;
+        }
+    }
+    const size_t input_count = inputs.size();
+    const uint64_t mask = maskOf(input_count);
+
+    uint64_t parity = 0;
+    for (uint64_t minterm = 0; minterm < (uint64_t(1) << input_count); minterm++) {
+        parity |= uint64_t(popcount(minterm) & 1) << minterm;
+    }
+
+    std::vector<Operand> literals;
+    Operand result;
+    if (function == 0) {
+        model->schematic->addWireBridge({ { out + "#const", { 1 } } });
+        result = { out + "#const_0", true };
+    } else if (function == mask) {
+        // A NOT gate with an unconnected input
+        const std::string gate = gateName(*model, out);
+        model->schematic->addNotGate(gate);
+        result = { gate + "_b", true };
+    } else if (popcount(function) == 1) {
+        // A single true minterm is an AND of literals
+        const int minterm = __builtin_ctzll(function);
+        for (size_t i = 0; i < input_count; i++) {
+            literals.push_back(literal(*model, inputs[i], !((minterm >> i) & 1)));
+        }
+        result = reduce(*model, GateKind::And, std::move(literals), out);
+    } else if (popcount(~function & mask) == 1) {
+        // A single false minterm is an OR of literals
+        const int minterm = __builtin_ctzll(~function & mask);
+        for (size_t i = 0; i < input_count; i++) {
+            literals.push_back(literal(*model, inputs[i], (minterm >> i) & 1));
+        }
+        result = reduce(*model, GateKind::Or, std::move(literals), out);
+    } else if (function == parity || function == (~parity & mask)) {
+        for (size_t i = 0; i < input_count; i++) {
+            literals.push_back({ inputs[i], false });
+        }
+        if (function == parity) {
+            result = reduce(*model, GateKind::Xor, std::move(literals), out);
+        } else {
+            const Operand xor_result = reduce(*model, GateKind::Xor, std::move(literals), out);
+            const std::string gate = gateName(*model, out);
+            model->schematic->addNotGate(gate);
+            connect(*model, xor_result, gate + "_a");
+            result = { gate + "_b", true };
+        }
+    } else {
+        fail("Unsupported cover for " + out + ", only AND, OR and XOR of literals and their complements are supported", current->line);
+    }
+
+    if (result.is_port) {
+        setDriver(*model, out, result.name, current->line);
+    } else {
+        // A buffer, the net is a copy of another one
+        if (model->drivers.count(out) || model->buffers.count(out)) {
+            fail("Net " + out + " is driven twice", current->line);
+        }
+        model->buffers[out] = result.name;
+    }
+}
+
+void BlifReader::addInstance(Model& model, const Instance& instance)
+{
+    auto it = interfaces.find(instance.model);
+    if (it == interfaces.end()) {
+        fail("Unknown model " + instance.model, instance.line);
+    }
+    model.schematic->addSubCircuit(instance.name, schematicFor(instance.model));
+    for (const auto& [formal, actual] : instance.bindings) {
+        const std::string port = instance.name + "_" + formal;
+        if (it->second.outputs.count(formal)) {
+            setDriver(model, actual, port, instance.line);
+        } else if (it->second.inputs.count(formal)) {
+            connect(model, { actual, false }, port);
+        } else {
+            fail("Model " + instance.model + " has no port " + formal, instance.line);
+        }
+    }
+}
+
+void BlifReader::setDriver(Model& model, const std::string& net, const std::string& port, size_t line)
+{
+    if (model.drivers.count(net) || model.buffers.count(net)) {
+        fail("Net " + net + " is driven twice", line);
+    }
+    model.drivers[net] = port;
+}
+
+void BlifReader::connect(Model& model, const Operand& source, const std::string& port)
+{
+    if (source.is_port) {
+        model.schematic->addConnection(source.name, port);
+        return;
+    }
+    auto it = model.drivers.find(source.name);
+    if (it != model.drivers.end()) {
+        model.schematic->addConnection(it->second, port);
+    } else {
+        model.sinks.emplace_back(source.name, port);
+    }
+}
+
+BlifReader::Operand BlifReader::literal(Model& model, const std::string& net, bool negated)
+{
+    if (!negated) {
+        return { net, false };
+    }
+    auto it = model.inverted.find(net);
+    if (it != model.inverted.end()) {
+        return { it->second, true };
+    }
+    const std::string gate = net + "#not";
+    model.schematic->addNotGate(gate);
+    connect(model, { net, false }, gate + "_a");
+    model.inverted[net] = gate + "_b";
+    return { gate + "_b", true };
+}
+
+BlifReader::Operand BlifReader::reduce(Model& model, GateKind kind, std::vector<Operand> operands, const std::string& net)
+{
+    // A balanced tree settles in fewer ticks than a chain
+    while (operands.size() > 1) {
+        std::vector<Operand> next;
+        for (size_t i = 0; i + 1 < operands.size(); i += 2) {
+            const std::string gate = gateName(model, net);
+            switch (kind) {
+            case GateKind::And:
+                model.schematic->addAndGate(gate);
+                break;
+            case GateKind::Or:
+                model.schematic->addOrGate(gate);
+                break;
+            case GateKind::Xor:
+                model.schematic->addXorGate(gate);
+                break;
+            }
+            connect(model, operands[i], gate + "_a");
+            connect(model, operands[i + 1], gate + "_b");
+            next.push_back({ gate + "_c", true });
+        }
+        if (operands.size() % 2 == 1) {
+            next.push_back(operands.back());
+        }
+        operands = std::move(next);
+    }
+    return operands[0];
+}
+
+std::string BlifReader::gateName(Model& model, const std::string& net)
+{
+    return net + "#" + std::to_string(model.gate_count++);
+}
+
+std::string BlifReader::findDriver(const Model& model, std::string net) const
+{
+    // A chain longer than the amount of buffers is a loop of buffers
+    for (size_t i = 0; i <= model.buffers.size(); i++) {
+        auto driver = model.drivers.find(net);
+        if (driver != model.drivers.end()) {
+            return driver->second;
+        }
+        auto buffer = model.buffers.find(net);
+        if (buffer == model.buffers.end()) {
+            return "";
+        }
+        net = buffer->second;
+    }
+    return "";
+}
@@ -1,9 +1,11 @@
 
 #include "boolStorage.hpp"
+#include "instrumentation.hpp"
 #include <iostream>
 
 BoolStorage BoolStorageAccessor::get() const
 {
+    CIRCUITSIM_INSTRUMENT(countAccessorLock();)
     auto buffer = buffer_ref.lock();
     if (buffer) {
         const auto mask = (ONES << socket_size).flip() << bit_offset;
@@ -16,6 +18,7 @@ BoolStorage BoolStorageAccessor::get() const
 
 void BoolStorageAccessor::set(BoolStorage value)
 {
+    CIRCUITSIM_INSTRUMENT(countAccessorLock();)
     auto buffer = buffer_ref.lock();
     if (buffer) {
         // std::cout << "Buffer:\n"
@@ -40,6 +43,7 @@ void BoolStorageAccessor::set(BoolStorage value)
 
 void BoolStorageAccessor::clear()
 {
+    CIRCUITSIM_INSTRUMENT(countAccessorLock();)
     auto buffer = buffer_ref.lock();
     if (buffer) {
         const auto mask = ((ONES << socket_size).flip() << bit_offset).flip();
@@ -52,6 +56,7 @@ void BoolStorageAccessor::clear()
 
 void BoolStorageAccessor::add(BoolStorage value)
 {
+    CIRCUITSIM_INSTRUMENT(countAccessorLock();)
     auto buffer = buffer_ref.lock();
     if (buffer) {
         const auto shifted = (value & (ONES >> (STORAGE_SIZE - socket_size))) << bit_offset;
@@ -64,6 +69,7 @@ void BoolStorageAccessor::add(BoolStorage value)
 
 void BoolStorageAccessor::multiply(BoolStorage value)
 {
+    CIRCUITSIM_INSTRUMENT(countAccessorLock();)
     auto buffer = buffer_ref.lock();
     if (buffer) {
         const auto shifted = (value & (ONES >> (STORAGE_SIZE - socket_size))) << bit_offset;
@@ -72,4 +78,14 @@ void BoolStorageAccessor::multiply(BoolStorage value)
         return;
     }
     throw std::runtime_error("BufferAccessor dereference failed");
-}
\ No newline at end of file
+}
+
+std::shared_ptr<BoolStorage> BoolStorageAccessor::getBuffer() const
+{
+    CIRCUITSIM_INSTRUMENT(countAccessorLock();)
+    auto buffer = buffer_ref.lock();
+    if (buffer) {
+        return buffer;
+    }
+    throw std::runtime_error("BufferAccessor dereference failed");
+}
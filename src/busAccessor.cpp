@@ -0,0 +1,111 @@
+#include "busAccessor.hpp"
+#include <algorithm>
+
+BusAccessor::BusAccessor(size_t bit_offset, size_t bit_count, std::weak_ptr<BoolStorage> first_word)
+    : bit_offset(bit_offset)
+    , bit_count(bit_count)
+    , buffer_ref(first_word)
+{
+    if (bit_offset >= STORAGE_SIZE) {
+        throw std::runtime_error("Accessor out of bounds");
+    }
+}
+
+BusAccessor::BusAccessor(const BoolStorageAccessor& accessor)
+    : BusAccessor(accessor.getBitOffset(), accessor.getSocketSize(), accessor.getBuffer())
+{
+}
+
+std::shared_ptr<BoolStorage> BusAccessor::getBuffer() const
+{
+    auto buffer = buffer_ref.lock();
+    if (buffer) {
+        return buffer;
+    }
+    throw std::runtime_error("BufferAccessor dereference failed");
+}
+
+BoolStorage BusAccessor::getWord(size_t index) const
+{
+    if (index >= wordCount()) {
+        throw std::runtime_error("Bus word out of bounds");
+    }
+    const BoolStorage* words = getBuffer().get();
+    const size_t start = bit_offset + index * STORAGE_SIZE;
+    const size_t word = start / STORAGE_SIZE;
+    const size_t shift = start % STORAGE_SIZE;
+    const size_t size = std::min(STORAGE_SIZE, bit_count - index * STORAGE_SIZE);
+
+    // Funnel the value together from the two words it straddles
+    BoolStorage value = words[word] >> shift;
+    if (shift != 0 && word + 1 < spannedWords()) {
+        value |= words[word + 1] << (STORAGE_SIZE - shift);
+    }
+    return value & (ONES >> (STORAGE_SIZE - size));
+}
+
+void BusAccessor::setWord(size_t index, BoolStorage value)
+{
+    if (index >= wordCount()) {
+        throw std::runtime_error("Bus word out of bounds");
+    }
+    BoolStorage* words = getBuffer().get();
+    const size_t start = bit_offset + index * STORAGE_SIZE;
+    const size_t word = start / STORAGE_SIZE;
+    const size_t shift = start % STORAGE_SIZE;
+    const size_t size = std::min(STORAGE_SIZE, bit_count - index * STORAGE_SIZE);
+    const BoolStorage mask = ONES >> (STORAGE_SIZE - size);
+    value &= mask;
+
+    words[word] = (words[word] & ~(mask << shift)) | (value << shift);
+    if (shift != 0 && shift + size > STORAGE_SIZE) {
+        words[word + 1] = (words[word + 1] & ~(mask >> (STORAGE_SIZE - shift))) | (value >> (STORAGE_SIZE - shift));
+    }
+}
+
+std::vector<BoolStorage> BusAccessor::get() const
+{
+    std::vector<BoolStorage> value(wordCount());
+    for (size_t i = 0; i < value.size(); i++) {
+        value[i] = getWord(i);
+    }
+    return value;
+}
+
+void BusAccessor::set(const std::vector<BoolStorage>& value)
+{
+    for (size_t i = 0; i < wordCount(); i++) {
+        setWord(i, i < value.size() ? value[i] : BoolStorage());
+    }
+}
+
+bool BusAccessor::getBit(size_t index) const
+{
+    if (index >= bit_count) {
+        throw std::runtime_error("Bus bit out of bounds");
+    }
+    const size_t position = bit_offset + index;
+    return getBuffer().get()[position / STORAGE_SIZE][position % STORAGE_SIZE];
+}
+
+void BusAccessor::setBit(size_t index, bool value)
+{
+    if (index >= bit_count) {
+        throw std::runtime_error("Bus bit out of bounds");
+    }
+    const size_t position = bit_offset + index;
+    getBuffer().get()[position / STORAGE_SIZE].set(position % STORAGE_SIZE, value);
+}
+
+BoolStorageAccessor BusAccessor::slice(size_t begin, size_t size) const
+{
+    if (begin + size > bit_count) {
+        throw std::runtime_error("Bus slice out of bounds");
+    }
+    const size_t position = bit_offset + begin;
+    if (position % STORAGE_SIZE + size > STORAGE_SIZE) {
+        throw std::runtime_error("Bus slice crosses a word boundary");
+    }
+    auto first_word = getBuffer();
+    return BoolStorageAccessor(position % STORAGE_SIZE, size, std::shared_ptr<BoolStorage>(first_word, first_word.get() + position / STORAGE_SIZE));
+}
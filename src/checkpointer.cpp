@@ -0,0 +1,176 @@
+#include "checkpointer.hpp"
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+constexpr char MAGIC[8] = { 'C', 'S', 'I', 'M', 'C', 'K', 'P', '\0' };
+constexpr size_t CHUNK_SIZE = StorageArena::CHUNK_SIZE;
+
+uint64_t mix(uint64_t hash, uint64_t value)
+{
+    return (hash ^ value) * 0x100000001b3ull;
+}
+
+}
+
+Checkpointer::Checkpointer(Managers& managers)
+    : managers(managers)
+{
+}
+
+uint64_t Checkpointer::layoutFingerprint() const
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    hash = mix(hash, managers.arena->size());
+    hash = mix(hash, managers.random_access_data_bank->size());
+    hash = mix(hash, managers.andGate->getDataBank().size());
+    hash = mix(hash, managers.notGate->getDataBank().size());
+    hash = mix(hash, managers.orGate->getDataBank().size());
+    hash = mix(hash, managers.xorGate->getDataBank().size());
+    hash = mix(hash, managers.socketController->getSockets().size());
+    return hash;
+}
+
+Checkpointer::Header Checkpointer::makeHeader(bool incremental) const
+{
+    Header header {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.incremental = incremental;
+    header.storage_size = STORAGE_SIZE;
+    header.word_bytes = sizeof(BoolStorage);
+    header.word_count = managers.arena->size();
+    header.layout = layoutFingerprint();
+    header.chain = chain;
+    header.sequence = sequence;
+    return header;
+}
+
+void Checkpointer::checkHeader(const Header& header) const
+{
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::runtime_error("Not a checkpoint");
+    }
+    if (header.version != VERSION) {
+        throw std::runtime_error("Unsupported checkpoint version " + std::to_string(header.version));
+    }
+    if (header.storage_size != STORAGE_SIZE || header.word_bytes != sizeof(BoolStorage)) {
+        throw std::runtime_error("Checkpoint was written with a storage size of " + std::to_string(header.storage_size));
+    }
+    if (header.word_count != managers.arena->size() || header.layout != layoutFingerprint()) {
+        throw std::runtime_error("Checkpoint was written from differently built managers");
+    }
+}
+
+void Checkpointer::save(std::ostream& out)
+{
+    StorageArena& arena = *managers.arena;
+    std::random_device random;
+    chain = (uint64_t(random()) << 32 | random()) | 1;
+    sequence = 0;
+    Header header = makeHeader(false);
+    header.changed_words = header.word_count;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    // The arena is written a chunk at a time, so the cost is dominated by copying memory
+    baseline.resize(header.word_count);
+    for (size_t first = 0; first < baseline.size(); first += CHUNK_SIZE) {
+        const BoolStorage* words = &arena.word(static_cast<uint32_t>(first));
+        out.write(reinterpret_cast<const char*>(words), sizeof(BoolStorage) * CHUNK_SIZE);
+        std::copy(words, words + CHUNK_SIZE, baseline.begin() + first);
+    }
+    if (!out) {
+        throw std::runtime_error("Could not write checkpoint");
+    }
+    last_words = baseline.size();
+}
+
+void Checkpointer::saveIncremental(std::ostream& out)
+{
+    if (chain == 0) {
+        throw std::runtime_error("Incremental checkpoint without a full checkpoint before it");
+    }
+    StorageArena& arena = *managers.arena;
+    if (arena.size() != baseline.size()) {
+        throw std::runtime_error("The circuit changed since the last checkpoint");
+    }
+
+    std::vector<uint64_t> bitmap((baseline.size() + 63) / 64);
+    std::vector<BoolStorage> changed;
+    for (size_t first = 0; first < baseline.size(); first += CHUNK_SIZE) {
+        const BoolStorage* words = &arena.word(static_cast<uint32_t>(first));
+        // Most chunks of a long simulation are unchanged, comparing them as a whole is cheap
+        if (std::memcmp(words, &baseline[first], sizeof(BoolStorage) * CHUNK_SIZE) == 0) {
+            continue;
+        }
+        for (size_t i = 0; i < CHUNK_SIZE; i++) {
+            if (words[i] != baseline[first + i]) {
+                bitmap[(first + i) / 64] |= uint64_t(1) << ((first + i) % 64);
+                changed.push_back(words[i]);
+                baseline[first + i] = words[i];
+            }
+        }
+    }
+
+    sequence++;
+    Header header = makeHeader(true);
+    header.changed_words = changed.size();
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(bitmap.data()), static_cast<std::streamsize>(sizeof(uint64_t) * bitmap.size()));
+    out.write(reinterpret_cast<const char*>(changed.data()), static_cast<std::streamsize>(sizeof(BoolStorage) * changed.size()));
+    if (!out) {
+        throw std::runtime_error("Could not write checkpoint");
+    }
+    last_words = changed.size();
+}
+
+void Checkpointer::restore(std::istream& in)
+{
+    Header header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        throw std::runtime_error("Checkpoint is truncated");
+    }
+    checkHeader(header);
+    StorageArena& arena = *managers.arena;
+
+    if (!header.incremental) {
+        baseline.resize(header.word_count);
+        if (!in.read(reinterpret_cast<char*>(baseline.data()), static_cast<std::streamsize>(sizeof(BoolStorage) * baseline.size()))) {
+            throw std::runtime_error("Checkpoint is truncated");
+        }
+    } else {
+        if (header.chain != chain || header.sequence != sequence + 1) {
+            throw std::runtime_error("Incremental checkpoint does not follow the last checkpoint");
+        }
+        std::vector<uint64_t> bitmap((baseline.size() + 63) / 64);
+        std::vector<BoolStorage> changed(std::min<uint64_t>(header.changed_words, baseline.size()));
+        if (!in.read(reinterpret_cast<char*>(bitmap.data()), static_cast<std::streamsize>(sizeof(uint64_t) * bitmap.size()))
+            || !in.read(reinterpret_cast<char*>(changed.data()), static_cast<std::streamsize>(sizeof(BoolStorage) * changed.size()))) {
+            throw std::runtime_error("Checkpoint is truncated");
+        }
+        // The changes apply to the state of the previous checkpoint, not to whatever was simulated since
+        size_t next = 0;
+        for (size_t block = 0; block < bitmap.size(); block++) {
+            for (uint64_t bits = bitmap[block]; bits != 0; bits &= bits - 1) {
+                const size_t index = block * 64 + __builtin_ctzll(bits);
+                if (next == changed.size() || index >= baseline.size()) {
+                    throw std::runtime_error("Checkpoint is corrupt");
+                }
+                baseline[index] = changed[next++];
+            }
+        }
+        if (next != header.changed_words) {
+            throw std::runtime_error("Checkpoint is corrupt");
+        }
+    }
+
+    for (size_t first = 0; first < baseline.size(); first += CHUNK_SIZE) {
+        std::copy(baseline.begin() + first, baseline.begin() + first + CHUNK_SIZE, &arena.word(static_cast<uint32_t>(first)));
+    }
+    chain = header.chain;
+    sequence = header.sequence;
+    last_words = header.changed_words;
+}
@@ -0,0 +1,247 @@
+#include "circuitImage.hpp"
+#include "gates/gateKernels.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr char MAGIC[8] = { 'C', 'S', 'I', 'M', 'I', 'M', 'G', '\0' };
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+// Sections start on a cache line, like the chunks of the arena
+constexpr uint64_t SECTION_ALIGNMENT = 64;
+
+template <size_t N>
+std::vector<CircuitImage::GateRun> gateRuns(DataBank<N>& bank)
+{
+    std::vector<CircuitImage::GateRun> runs;
+    for (size_t i = 0; i < bank.spanCount(); i++) {
+        const size_t first = i * DataBank<N>::CHUNK_SIZE;
+        CircuitImage::GateRun run { bank.wordIndex(0, first), bank.wordIndex(1, first), 0, static_cast<uint32_t>(bank.spanSize(i)) };
+        if constexpr (N > 2) {
+            run.c = bank.wordIndex(2, first);
+        }
+        runs.push_back(run);
+    }
+    return runs;
+}
+
+uint32_t arenaIndex(const StorageArena& arena, const BoolStorage* word)
+{
+    const uint32_t index = arena.wordIndex(word);
+    if (index == StorageArena::NONE) {
+        throw std::runtime_error("Socket does not point into the arena");
+    }
+    return index;
+}
+
+/// @brief Appends aligned sections to a file
+class SectionWriter {
+    std::ofstream& out;
+    uint64_t offset;
+
+public:
+    SectionWriter(std::ofstream& out, uint64_t offset)
+        : out(out)
+        , offset(offset)
+    {
+    }
+
+    template <typename T>
+    CircuitImage::Section append(const T* data, size_t count)
+    {
+        static const char padding[SECTION_ALIGNMENT] = {};
+        const uint64_t aligned = (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+        out.write(padding, static_cast<std::streamsize>(aligned - offset));
+        out.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(sizeof(T) * count));
+        offset = aligned + sizeof(T) * count;
+        return { aligned, count };
+    }
+
+    template <typename T>
+    CircuitImage::Section append(const std::vector<T>& data)
+    {
+        return append(data.data(), data.size());
+    }
+
+    uint64_t size() const { return offset; }
+};
+
+void checkSection(const CircuitImage::Header& header, const CircuitImage::Section& section, size_t element_size)
+{
+    if (section.offset % SECTION_ALIGNMENT != 0 || section.offset > header.file_size
+        || section.count > (header.file_size - section.offset) / element_size) {
+        throw std::runtime_error("Circuit image section out of bounds");
+    }
+}
+
+}
+
+struct CircuitImage::Mapping {
+    void* data;
+    size_t size;
+
+    ~Mapping() { munmap(data, size); }
+};
+
+void CircuitImage::write(const std::string& path, Managers& managers, const Circuit& circuit)
+{
+    const StorageArena& arena = *managers.arena;
+
+    std::vector<BoolStorage> state(arena.size());
+    for (size_t i = 0; i < state.size(); i++) {
+        state[i] = arena.word(static_cast<uint32_t>(i));
+    }
+
+    std::vector<Transfer> plan;
+    for (const auto& transfer : managers.socketController->getPlan()) {
+        plan.push_back({ transfer.from_mask, transfer.keep_mask, arenaIndex(arena, transfer.from), arenaIndex(arena, transfer.to), transfer.shift, transfer.whole_word });
+    }
+
+    std::vector<std::pair<std::string_view, StorageHandle>> named_ports;
+    for (const auto [name, accessor] : circuit.bool_storage_access_map) {
+        if (accessor.getSocketSize() > 0) {
+            named_ports.emplace_back(name, arena.handle(accessor));
+        }
+    }
+    std::sort(named_ports.begin(), named_ports.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    std::vector<Port> port_table;
+    std::string name_data;
+    for (const auto& [name, handle] : named_ports) {
+        port_table.push_back({ static_cast<uint32_t>(name_data.size()), static_cast<uint32_t>(name.size()), handle });
+        name_data += name;
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Could not open " + path + " for writing");
+    }
+    Header header {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.byte_order = BYTE_ORDER_MARK;
+    header.storage_size = STORAGE_SIZE;
+    header.word_bytes = sizeof(BoolStorage);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    SectionWriter sections(out, sizeof(header));
+    header.words = sections.append(state);
+    header.gates[0] = sections.append(gateRuns(managers.andGate->getDataBank()));
+    header.gates[1] = sections.append(gateRuns(managers.notGate->getDataBank()));
+    header.gates[2] = sections.append(gateRuns(managers.orGate->getDataBank()));
+    header.gates[3] = sections.append(gateRuns(managers.xorGate->getDataBank()));
+    header.transfers = sections.append(plan);
+    header.ports = sections.append(port_table);
+    header.names = sections.append(name_data.data(), name_data.size());
+    header.file_size = sections.size();
+
+    // The header is written last, once the sections are known
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!out) {
+        throw std::runtime_error("Could not write " + path);
+    }
+}
+
+CircuitImage::CircuitImage(const std::string& path)
+{
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Could not open " + path);
+    }
+    struct stat status;
+    if (fstat(fd, &status) != 0 || static_cast<size_t>(status.st_size) < sizeof(Header)) {
+        close(fd);
+        throw std::runtime_error("Not a circuit image: " + path);
+    }
+    const size_t size = static_cast<size_t>(status.st_size);
+    // A private mapping lets ticks write to the words without touching the file
+    void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        throw std::runtime_error("Could not map " + path);
+    }
+    mapping.reset(new Mapping { data, size });
+
+    auto* bytes = static_cast<char*>(data);
+    header = reinterpret_cast<const Header*>(bytes);
+    if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->byte_order != BYTE_ORDER_MARK) {
+        throw std::runtime_error("Not a circuit image: " + path);
+    }
+    if (header->version != VERSION) {
+        throw std::runtime_error("Unsupported circuit image version " + std::to_string(header->version));
+    }
+    if (header->storage_size != STORAGE_SIZE || header->word_bytes != sizeof(BoolStorage)) {
+        throw std::runtime_error("Circuit image was written with a storage size of " + std::to_string(header->storage_size));
+    }
+    if (header->file_size != size) {
+        throw std::runtime_error("Circuit image is truncated");
+    }
+    checkSection(*header, header->words, sizeof(BoolStorage));
+    for (const auto& section : header->gates) {
+        checkSection(*header, section, sizeof(GateRun));
+    }
+    checkSection(*header, header->transfers, sizeof(Transfer));
+    checkSection(*header, header->ports, sizeof(Port));
+    checkSection(*header, header->names, 1);
+
+    words = reinterpret_cast<BoolStorage*>(bytes + header->words.offset);
+    for (size_t i = 0; i < gates.size(); i++) {
+        gates[i] = reinterpret_cast<const GateRun*>(bytes + header->gates[i].offset);
+    }
+    transfers = reinterpret_cast<const Transfer*>(bytes + header->transfers.offset);
+    ports = reinterpret_cast<const Port*>(bytes + header->ports.offset);
+    names = bytes + header->names.offset;
+}
+
+CircuitImage::CircuitImage(CircuitImage&& other) noexcept = default;
+CircuitImage& CircuitImage::operator=(CircuitImage&& other) noexcept = default;
+CircuitImage::~CircuitImage() = default;
+
+void CircuitImage::tick()
+{
+    for (size_t i = 0; i < header->gates[0].count; i++) {
+        const GateRun& run = gates[0][i];
+        andKernel(words + run.a, words + run.b, words + run.c, run.size);
+    }
+    for (size_t i = 0; i < header->gates[1].count; i++) {
+        const GateRun& run = gates[1][i];
+        notKernel(words + run.a, words + run.b, run.size);
+    }
+    for (size_t i = 0; i < header->gates[2].count; i++) {
+        const GateRun& run = gates[2][i];
+        orKernel(words + run.a, words + run.b, words + run.c, run.size);
+    }
+    for (size_t i = 0; i < header->gates[3].count; i++) {
+        const GateRun& run = gates[3][i];
+        xorKernel(words + run.a, words + run.b, words + run.c, run.size);
+    }
+    for (size_t i = 0; i < header->transfers.count; i++) {
+        const Transfer& transfer = transfers[i];
+        BoolStorage& to = words[transfer.to];
+        if (transfer.whole_word) {
+            to = words[transfer.from];
+            continue;
+        }
+        const BoolStorage bits = words[transfer.from] & transfer.from_mask;
+        to &= transfer.keep_mask;
+        to |= transfer.shift >= 0 ? bits << transfer.shift : bits >> -transfer.shift;
+    }
+}
+
+StorageHandle CircuitImage::find(std::string_view name) const
+{
+    const Port* end = ports + header->ports.count;
+    const Port* port = std::lower_bound(ports, end, name, [this](const Port& port, std::string_view name) { return portName(port) < name; });
+    if (port == end || portName(*port) != name) {
+        throw std::runtime_error("Unknown port " + std::string(name));
+    }
+    return port->handle;
+}
@@ -1,62 +1,87 @@
 #include "circuitSchematic.hpp"
 #include "managers.hpp"
-#include <stack>
-
-std::tuple<std::vector<WireBridgeData>, std::vector<std::vector<std::vector<std::string>>>> CircuitSchematic::generateWireBridgeData() const
-{
-    std::vector<std::vector<std::vector<size_t>>> port_sizes;
-    std::vector<std::vector<std::vector<std::string>>> port_names;
-    const std::vector<std::vector<BridgeView>>& wire_bridges = this->wire_bridges;
-    for (const auto& bridge : wire_bridges) {
-        std::vector<std::vector<size_t>> bridge_port_sizes;
-        std::vector<std::vector<std::string>> bridge_port_names;
-        for (const auto& view : bridge) {
-            bridge_port_sizes.push_back(view.port_sizes);
-            std::vector<std::string> view_names;
-            for (size_t i = 0; i < view.port_sizes.size(); ++i) {
-                view_names.push_back(view.name + "_" + std::to_string(i));
-            }
-            bridge_port_names.push_back(view_names);
-        }
-        port_sizes.push_back(bridge_port_sizes);
-        port_names.push_back(bridge_port_names);
-    }
-
-    return { port_sizes, port_names };
-}
+#include "memoryReport.hpp"
+#include <algorithm>
+#include <tuple>
 
 void CircuitSchematic::addAndGate(std::string name)
 {
+    modified();
     and_gates.push_back(name);
 }
 
 void CircuitSchematic::addNotGate(std::string name)
 {
+    modified();
     not_gates.push_back(name);
 }
 
 void CircuitSchematic::addOrGate(std::string name)
 {
+    modified();
     or_gates.push_back(name);
 }
 
 void CircuitSchematic::addXorGate(std::string name)
 {
+    modified();
     xor_gates.push_back(name);
 }
 
+namespace {
+
+void checkGateArraySize(size_t count)
+{
+    if (count == 0 || count > STORAGE_SIZE) {
+        throw std::runtime_error("Gate array size must be between 1 and STORAGE_SIZE");
+    }
+}
+
+}
+
+void CircuitSchematic::addAndGateArray(std::string name, size_t count)
+{
+    checkGateArraySize(count);
+    modified();
+    and_gate_arrays.push_back({ name, count });
+}
+
+void CircuitSchematic::addNotGateArray(std::string name, size_t count)
+{
+    checkGateArraySize(count);
+    modified();
+    not_gate_arrays.push_back({ name, count });
+}
+
+void CircuitSchematic::addOrGateArray(std::string name, size_t count)
+{
+    checkGateArraySize(count);
+    modified();
+    or_gate_arrays.push_back({ name, count });
+}
+
+void CircuitSchematic::addXorGateArray(std::string name, size_t count)
+{
+    checkGateArraySize(count);
+    modified();
+    xor_gate_arrays.push_back({ name, count });
+}
+
 void CircuitSchematic::addWireBridge(Bridge wire_bridge)
 {
+    modified();
     wire_bridges.push_back(wire_bridge);
 }
 
 void CircuitSchematic::addConnection(std::string from, std::string to)
 {
+    modified();
     connections.push_back(std::make_tuple(from, to));
 }
 
 void CircuitSchematic::addExposedPort(std::string port)
 {
+    modified();
     exposed_ports.push_back(port);
 }
 
@@ -79,11 +104,13 @@ void CircuitSchematic::addSubCircuit(std::string name, std::weak_ptr<CircuitSche
         dependencies.insert(dependency);
     }
 
+    modified();
     sub_circuits.push_back(std::make_tuple(name, schematic));
 }
 
 void CircuitSchematic::addAlias(std::string target_port, std::string alias)
 {
+    modified();
     aliases[alias] = target_port;
 }
 
@@ -100,147 +127,534 @@ std::string CircuitSchematic::resolveAlias(std::string port) const
     return port;
 }
 
-std::shared_ptr<Circuit> CircuitSchematic::earlyGenerate()
+void CircuitSchematic::modified()
+{
+    revision++;
+    layout.reset();
+}
+
+std::shared_ptr<const CircuitSchematic::Layout> CircuitSchematic::getLayout()
+{
+    std::vector<std::shared_ptr<CircuitSchematic>> sub_schematics;
+    std::vector<size_t> sub_revisions;
+    for (const auto& [sub_name, w_sub_schematic] : sub_circuits) {
+        auto sub_schematic = w_sub_schematic.lock();
+        if (!sub_schematic) {
+            throw std::runtime_error("Circuit schematic or parent circuit is expired");
+        }
+        sub_revisions.push_back(sub_schematic->revision);
+        sub_schematics.push_back(sub_schematic);
+    }
+    if (layout && layout->sub_revisions == sub_revisions) {
+        return layout;
+    }
+
+    auto result = std::make_shared<Layout>();
+    result->and_count = and_gates.size();
+    result->not_count = not_gates.size();
+    result->or_count = or_gates.size();
+    result->xor_count = xor_gates.size();
+    auto ports = std::make_shared<PortLayout>();
+    auto exposed = std::make_shared<PortLayout>();
+    result->sub_revisions = sub_revisions;
+
+    // Gate and wire bridge ports, in the order lateGenerate lends them
+    auto& slot_sizes = result->slot_sizes;
+    auto addPort = [&](const std::string& name, size_t size) {
+        const uint32_t slot = ports->add(name);
+        slot_sizes.resize(ports->slotCount());
+        slot_sizes[slot] = size;
+        return slot;
+    };
+    auto addGates = [&](const std::vector<std::string>& gates, std::initializer_list<const char*> suffixes) {
+        for (const auto& name : gates) {
+            for (const char* suffix : suffixes) {
+                result->gate_slots.push_back(addPort(name + suffix, 1));
+            }
+        }
+    };
+    addGates(and_gates, { "_a", "_b", "_c" });
+    addGates(not_gates, { "_a", "_b" });
+    addGates(or_gates, { "_a", "_b", "_c" });
+    addGates(xor_gates, { "_a", "_b", "_c" });
+    auto addGateArrays = [&](const std::vector<GateArray>& arrays, std::initializer_list<const char*> suffixes, std::vector<Layout::GateArrayLayout>& layouts) {
+        for (const auto& array : arrays) {
+            Layout::GateArrayLayout array_layout { array.size, {} };
+            for (const char* suffix : suffixes) {
+                array_layout.slots.push_back(addPort(array.name + suffix, array.size));
+            }
+            for (size_t i = 0; i < array.size; i++) {
+                for (const char* suffix : suffixes) {
+                    array_layout.slots.push_back(addPort(array.name + "_" + std::to_string(i) + suffix, 1));
+                }
+            }
+            layouts.push_back(std::move(array_layout));
+        }
+    };
+    addGateArrays(and_gate_arrays, { "_a", "_b", "_c" }, result->gate_arrays[0]);
+    addGateArrays(not_gate_arrays, { "_a", "_b" }, result->gate_arrays[1]);
+    addGateArrays(or_gate_arrays, { "_a", "_b", "_c" }, result->gate_arrays[2]);
+    addGateArrays(xor_gate_arrays, { "_a", "_b", "_c" }, result->gate_arrays[3]);
+    for (const auto& bridge : wire_bridges) {
+        WireBridgeData data;
+        for (const auto& view : bridge) {
+            data.push_back(view.port_sizes);
+        }
+        Layout::BridgeLayout bridge_layout { wireBridgeWidth(data), {}, false };
+        for (const auto& view : bridge) {
+            size_t offset = 0;
+            for (size_t i = 0; i < view.port_sizes.size(); ++i) {
+                bridge_layout.ports.push_back({ addPort(view.name + "_" + std::to_string(i), view.port_sizes[i]), offset, view.port_sizes[i] });
+                offset += view.port_sizes[i];
+            }
+        }
+        result->bridges.push_back(std::move(bridge_layout));
+    }
+
+    // Ports exposed by the sub-circuits
+    for (size_t i = 0; i < sub_circuits.size(); i++) {
+        auto sub_layout = sub_schematics[i]->getLayout();
+        std::vector<uint32_t> export_slots;
+        for (size_t j = 0; j < sub_layout->exposed_slots.size(); j++) {
+            const size_t size = sub_layout->slot_sizes[sub_layout->exposed_slots[j].first];
+            export_slots.push_back(addPort(std::get<0>(sub_circuits[i]) + "_" + sub_schematics[i]->exposed_ports[j], size));
+        }
+        result->sub_export_slots.push_back(std::move(export_slots));
+    }
+
+    for (const auto& [alias, target] : aliases) {
+        std::string base_target = resolveAlias(target);
+        const uint32_t slot = ports->find(base_target);
+        if (slot == PortLayout::NONE) {
+            throw std::runtime_error(std::string("Alias target ") + base_target + " not found");
+        }
+        ports->alias(alias, slot);
+    }
+
+    for (const auto& [from, to] : connections) {
+        const uint32_t from_slot = ports->find(from);
+        if (from_slot == PortLayout::NONE) {
+            throw std::runtime_error(std::string("Connection port ") + from + " not found");
+        }
+        const uint32_t to_slot = ports->find(to);
+        if (to_slot == PortLayout::NONE) {
+            throw std::runtime_error(std::string("Connection port ") + to + " not found");
+        }
+        result->connections.push_back({ from_slot, to_slot });
+    }
+
+    for (const auto& exposed_port : exposed_ports) {
+        const uint32_t slot = ports->find(exposed_port);
+        if (slot == PortLayout::NONE) {
+            throw std::runtime_error(std::string("Exposed port ") + exposed_port + " not found");
+        }
+        result->exposed_slots.push_back({ slot, exposed->add(exposed_port) });
+    }
+
+    resolveCoalescing(*result);
+    resolvePlacement(*result);
+    result->ports = ports;
+    result->exposed = exposed;
+    layout = result;
+    return layout;
+}
+
+void CircuitSchematic::resolveCoalescing(Layout& layout) const
+{
+    constexpr uint32_t NONE = PortLayout::NONE;
+    const size_t slot_count = layout.slot_sizes.size();
+
+    // Only ports of single view bridges can move, the views of a bridge share its bits
+    std::vector<uint32_t> bridge_of(slot_count, NONE);
+    for (size_t i = 0; i < layout.bridges.size(); i++) {
+        if (wire_bridges[i].size() == 1) {
+            for (const auto& port : layout.bridges[i].ports) {
+                bridge_of[port.slot] = static_cast<uint32_t>(i);
+            }
+        }
+    }
+    std::vector<uint32_t> driver_count(slot_count);
+    for (const auto& [from, to] : layout.connections) {
+        driver_count[to]++;
+    }
+
+    // Union-find over the slots, every coalescible port points at its only driver
+    std::vector<uint32_t> parent(slot_count, NONE);
+    for (const auto& [from, to] : layout.connections) {
+        if (bridge_of[to] != NONE && driver_count[to] == 1 && from != to && layout.slot_sizes[from] == layout.slot_sizes[to]) {
+            parent[to] = from;
+        }
+    }
+    std::vector<uint32_t> root(slot_count, NONE);
+    std::vector<bool> on_path(slot_count);
+    std::vector<uint32_t> path;
+    for (uint32_t slot = 0; slot < slot_count; slot++) {
+        uint32_t current = slot;
+        while (parent[current] != NONE && root[current] == NONE && !on_path[current]) {
+            on_path[current] = true;
+            path.push_back(current);
+            current = parent[current];
+        }
+        // A loop of ports without an outside driver keeps the socket into one of them
+        if (on_path[current]) {
+            parent[current] = NONE;
+        }
+        const uint32_t found = parent[current] == NONE ? current : root[current];
+        for (uint32_t port : path) {
+            root[port] = found;
+            on_path[port] = false;
+        }
+        path.clear();
+    }
+
+    for (uint32_t slot = 0; slot < slot_count; slot++) {
+        if (parent[slot] != NONE) {
+            layout.coalescible.push_back({ slot, root[slot] });
+        }
+    }
+    for (const auto& [from, to] : layout.connections) {
+        layout.coalescible_connections.push_back(parent[to] == from);
+    }
+    for (auto& bridge : layout.bridges) {
+        bridge.coalescible = std::all_of(bridge.ports.begin(), bridge.ports.end(), [&](const Layout::BridgePort& port) {
+            return parent[port.slot] != NONE;
+        });
+    }
+}
+
+void CircuitSchematic::resolvePlacement(Layout& layout)
+{
+    constexpr uint32_t NONE = PortLayout::NONE;
+    const size_t slot_count = layout.slot_sizes.size();
+
+    // Every gate and every wire bridge is a unit, gates numbered in lending order before the bridges
+    const size_t kind_counts[] = { layout.and_count, layout.not_count, layout.or_count, layout.xor_count };
+    const size_t kind_ports[] = { 3, 2, 3, 3 };
+    std::vector<uint32_t> slot_unit(slot_count, NONE);
+    std::vector<size_t> unit_first_slot;
+    size_t next_slot = 0;
+    for (size_t kind = 0; kind < 4; kind++) {
+        for (size_t i = 0; i < kind_counts[kind]; i++) {
+            unit_first_slot.push_back(next_slot);
+            for (size_t port = 0; port < kind_ports[kind]; port++) {
+                slot_unit[layout.gate_slots[next_slot++]] = static_cast<uint32_t>(unit_first_slot.size() - 1);
+            }
+        }
+    }
+    const size_t gate_count = unit_first_slot.size();
+    for (size_t i = 0; i < layout.bridges.size(); i++) {
+        for (const auto& port : layout.bridges[i].ports) {
+            slot_unit[port.slot] = static_cast<uint32_t>(gate_count + i);
+        }
+    }
+    const size_t unit_count = gate_count + layout.bridges.size();
+
+    // Undirected adjacency of the units in compressed rows
+    std::vector<uint32_t> row_starts(unit_count + 1);
+    for (const auto& [from, to] : layout.connections) {
+        if (slot_unit[from] != NONE && slot_unit[to] != NONE) {
+            row_starts[slot_unit[from] + 1]++;
+            row_starts[slot_unit[to] + 1]++;
+        }
+    }
+    for (size_t i = 0; i < unit_count; i++) {
+        row_starts[i + 1] += row_starts[i];
+    }
+    std::vector<uint32_t> neighbours(row_starts.back());
+    std::vector<uint32_t> fill(row_starts.begin(), row_starts.end() - 1);
+    for (const auto& [from, to] : layout.connections) {
+        if (slot_unit[from] != NONE && slot_unit[to] != NONE) {
+            neighbours[fill[slot_unit[from]]++] = slot_unit[to];
+            neighbours[fill[slot_unit[to]]++] = slot_unit[from];
+        }
+    }
+
+    std::vector<uint32_t> rank(unit_count, NONE);
+    std::vector<uint32_t> queue;
+    queue.reserve(unit_count);
+    auto walk = [&](uint32_t start) {
+        if (start == NONE || rank[start] != NONE) {
+            return;
+        }
+        rank[start] = static_cast<uint32_t>(queue.size());
+        queue.push_back(start);
+        for (size_t head = queue.size() - 1; head < queue.size(); head++) {
+            const uint32_t unit = queue[head];
+            for (uint32_t i = row_starts[unit]; i < row_starts[unit + 1]; i++) {
+                if (rank[neighbours[i]] == NONE) {
+                    rank[neighbours[i]] = static_cast<uint32_t>(queue.size());
+                    queue.push_back(neighbours[i]);
+                }
+            }
+        }
+    };
+    for (const auto& [slot, exposed_slot] : layout.exposed_slots) {
+        walk(slot_unit[slot]);
+    }
+    for (uint32_t unit = 0; unit < unit_count; unit++) {
+        walk(unit);
+    }
+
+    // Gates only move within their kind, every kind is lent from a bank of its own
+    std::vector<uint32_t> order(unit_count);
+    for (uint32_t unit = 0; unit < unit_count; unit++) {
+        order[unit] = unit;
+    }
+    auto by_rank = [&](uint32_t a, uint32_t b) { return rank[a] < rank[b]; };
+    size_t first = 0;
+    for (size_t kind = 0; kind < 4; kind++) {
+        std::sort(order.begin() + first, order.begin() + first + kind_counts[kind], by_rank);
+        for (size_t i = first; i < first + kind_counts[kind]; i++) {
+            for (size_t port = 0; port < kind_ports[kind]; port++) {
+                layout.placed_gate_slots.push_back(layout.gate_slots[unit_first_slot[order[i]] + port]);
+            }
+        }
+        first += kind_counts[kind];
+    }
+    std::sort(order.begin() + gate_count, order.end(), by_rank);
+    for (size_t i = gate_count; i < unit_count; i++) {
+        layout.placed_bridges.push_back(static_cast<uint32_t>(order[i] - gate_count));
+    }
+
+    // Connections into the same port keep their order, the last one written wins
+    std::vector<uint32_t> target_rank;
+    for (const auto& [from, to] : layout.connections) {
+        target_rank.push_back(slot_unit[to] == NONE ? NONE : rank[slot_unit[to]]);
+        layout.placed_connections.push_back(static_cast<uint32_t>(layout.placed_connections.size()));
+    }
+    std::stable_sort(layout.placed_connections.begin(), layout.placed_connections.end(), [&](uint32_t a, uint32_t b) {
+        return target_rank[a] < target_rank[b];
+    });
+}
+
+std::shared_ptr<Circuit> CircuitSchematic::earlyGenerate(const Layout& layout, const Managers& managers)
 {
     auto circuit = std::make_shared<Circuit>();
+    circuit->bool_storage_access_map = PortTable(layout.ports, managers.arena);
+    circuit->exposed_ports = PortTable(layout.exposed, managers.arena);
     return circuit;
 }
 
-void CircuitSchematic::lateGenerate(std::shared_ptr<Circuit> circuit, Managers& managers, std::shared_ptr<Circuit> parent, std::string name_in_parent)
+void CircuitSchematic::lateGenerate(Circuit& circuit, const Layout& layout, Managers& managers, Circuit* parent, const std::vector<uint32_t>* export_slots, const BuildOptions& options)
 {
+    PortTable& ports = circuit.bool_storage_access_map;
+    auto next_slot = options.place_gates ? layout.placed_gate_slots.begin() : layout.gate_slots.begin();
 
     // Add gates
 
-    for (const auto& name : and_gates) {
-        auto [a, b, c] = managers.andGate->lendGate();
-        circuit->bool_storage_access_map[name + "_a"] = a;
-        circuit->bool_storage_access_map[name + "_b"] = b;
-        circuit->bool_storage_access_map[name + "_c"] = c;
+    auto and_gate_handles = managers.andGate->lendGateHandles(layout.and_count);
+    for (const auto& [a, b, c] : and_gate_handles) {
+        ports.setSlot(*next_slot++, a);
+        ports.setSlot(*next_slot++, b);
+        ports.setSlot(*next_slot++, c);
     }
 
-    for (const auto& name : not_gates) {
-        auto [a, b] = managers.notGate->lendGate();
-        circuit->bool_storage_access_map[name + "_a"] = a;
-        circuit->bool_storage_access_map[name + "_b"] = b;
+    auto not_gate_handles = managers.notGate->lendGateHandles(layout.not_count);
+    for (const auto& [a, b] : not_gate_handles) {
+        ports.setSlot(*next_slot++, a);
+        ports.setSlot(*next_slot++, b);
     }
 
-    for (const auto& name : or_gates) {
-        auto [a, b, c] = managers.orGate->lendGate();
-        circuit->bool_storage_access_map[name + "_a"] = a;
-        circuit->bool_storage_access_map[name + "_b"] = b;
-        circuit->bool_storage_access_map[name + "_c"] = c;
+    auto or_gate_handles = managers.orGate->lendGateHandles(layout.or_count);
+    for (const auto& [a, b, c] : or_gate_handles) {
+        ports.setSlot(*next_slot++, a);
+        ports.setSlot(*next_slot++, b);
+        ports.setSlot(*next_slot++, c);
     }
 
-    for (const auto& name : xor_gates) {
-        auto [a, b, c] = managers.xorGate->lendGate();
-        circuit->bool_storage_access_map[name + "_a"] = a;
-        circuit->bool_storage_access_map[name + "_b"] = b;
-        circuit->bool_storage_access_map[name + "_c"] = c;
+    auto xor_gate_handles = managers.xorGate->lendGateHandles(layout.xor_count);
+    for (const auto& [a, b, c] : xor_gate_handles) {
+        ports.setSlot(*next_slot++, a);
+        ports.setSlot(*next_slot++, b);
+        ports.setSlot(*next_slot++, c);
     }
 
-    // Add wire bridges
-    auto [wire_bridge_data, wire_bridge_names] = generateWireBridgeData();
-    std::vector<std::vector<std::vector<BoolStorageAccessor>>> circuit_bridge_accessors;
-    std::vector<std::vector<std::vector<std::string>>> circuit_bridge_names;
-    for (auto& schematic_bridge : wire_bridge_data) {
-        circuit_bridge_accessors.emplace_back(std::move(wireBridge(*managers.random_access_data_bank, schematic_bridge)));
-    }
-    for (size_t i = 0; i < circuit_bridge_accessors.size(); i++) {
-        auto& cba = circuit_bridge_accessors[i];
-        auto& cbn = wire_bridge_names[i];
-        for (size_t j = 0; j < cba.size(); j++) {
-            auto& cba2 = cba[j];
-            auto& cbn2 = cbn[j];
-            for (size_t k = 0; k < cba2.size(); k++) {
-                circuit->bool_storage_access_map[cbn2[k]] = cba2[k];
+    // Add gate arrays, every gate of an array sees its own bit of the array's ports
+    auto addGateArrays = [&](const std::vector<Layout::GateArrayLayout>& arrays, auto lend) {
+        for (const auto& array : arrays) {
+            const auto handles = lend(array.size);
+            const size_t port_count = handles.size();
+            for (size_t port = 0; port < port_count; port++) {
+                const StorageHandle handle = handles[port];
+                ports.setSlot(array.slots[port], handle);
+                for (size_t i = 0; i < array.size; i++) {
+                    ports.setSlot(array.slots[port_count * (i + 1) + port], StorageHandle { handle.word, static_cast<uint16_t>(handle.bit_offset + i), 1 });
+                }
             }
         }
+    };
+    addGateArrays(layout.gate_arrays[0], [&](size_t count) { return managers.andGate->lendGateArrayHandles(count); });
+    addGateArrays(layout.gate_arrays[1], [&](size_t count) { return managers.notGate->lendGateArrayHandles(count); });
+    addGateArrays(layout.gate_arrays[2], [&](size_t count) { return managers.orGate->lendGateArrayHandles(count); });
+    addGateArrays(layout.gate_arrays[3], [&](size_t count) { return managers.xorGate->lendGateArrayHandles(count); });
+
+    // Add wire bridges, relocating their ports to the bits lent to them
+    for (size_t i = 0; i < layout.bridges.size(); i++) {
+        const auto& bridge = layout.bridges[options.place_gates ? layout.placed_bridges[i] : i];
+        if (options.coalesce_sockets && bridge.coalescible) {
+            continue;
+        }
+        auto [bits] = managers.random_access_data_bank->lendHandles(bridge.width);
+        for (const auto& port : bridge.ports) {
+            ports.setSlot(port.slot, StorageHandle { bits.word, static_cast<uint16_t>(bits.bit_offset + port.offset), static_cast<uint16_t>(port.size) });
+        }
     }
 
-    // Add aliases to access map
-    for (const auto& [alias, target] : aliases) {
-        std::string base_target = resolveAlias(target);
-        if (circuit->bool_storage_access_map.find(base_target) == circuit->bool_storage_access_map.end()) {
-            throw std::runtime_error(std::string("Alias target ") + base_target + " not found");
+    // Let coalescible ports share the storage of their drivers, which sub-circuits and the steps above already set
+    if (options.coalesce_sockets) {
+        for (const auto& [slot, driver] : layout.coalescible) {
+            ports.copySlot(slot, ports, driver);
         }
-        circuit->bool_storage_access_map[alias] = circuit->bool_storage_access_map[base_target];
     }
 
     // Add connections
-    for (const auto& [from, to] : connections) {
-        if (circuit->bool_storage_access_map.find(from) == circuit->bool_storage_access_map.end() || circuit->bool_storage_access_map.find(to) == circuit->bool_storage_access_map.end()) {
-            if (circuit->bool_storage_access_map.find(from) == circuit->bool_storage_access_map.end()) {
-                throw std::runtime_error(std::string("Connection port ") + from + " not found");
-            }
-            throw std::runtime_error(std::string("Connection port ") + to + " not found");
+    for (size_t j = 0; j < layout.connections.size(); j++) {
+        const size_t i = options.place_gates ? layout.placed_connections[j] : j;
+        if (options.coalesce_sockets && layout.coalescible_connections[i]) {
+            continue;
         }
-        managers.socketController->addSocket(circuit->bool_storage_access_map[from], circuit->bool_storage_access_map[to]);
+        const auto& [from, to] = layout.connections[i];
+        managers.socketController->addSocket(ports.slot(from), ports.slot(to));
     }
 
     // Add exposed ports
-    for (const auto& exposed_port : exposed_ports) {
-        if (circuit->bool_storage_access_map.find(exposed_port) == circuit->bool_storage_access_map.end()) {
-            throw std::runtime_error(std::string("Exposed port ") + exposed_port + " not found");
-        }
+    for (size_t i = 0; i < layout.exposed_slots.size(); i++) {
+        const auto& [slot, exposed_slot] = layout.exposed_slots[i];
         // Add the exposed port to the map of exposed ports
-        circuit->exposed_ports[exposed_port] = circuit->bool_storage_access_map[exposed_port];
+        circuit.exposed_ports.copySlot(exposed_slot, ports, slot);
         // Add the exposed port to the parent's map of all ports
-        parent->bool_storage_access_map[name_in_parent + "_" + exposed_port] = circuit->bool_storage_access_map[exposed_port];
+        if (parent) {
+            parent->bool_storage_access_map.copySlot((*export_slots)[i], ports, slot);
+        }
     }
 }
 
-std::shared_ptr<Circuit> CircuitSchematic::build(Managers& managers)
-{
+struct CircuitSchematic::BankEstimate {
+    /// @brief The amount of open words by their amount of free bits
+    std::array<size_t, STORAGE_SIZE + 1> open_words {};
+    size_t words = 0;
+    size_t new_words = 0;
+
+    template <size_t N>
+    explicit BankEstimate(const DataBank<N>& bank)
+        : words(bank.size())
+    {
+        for (size_t free_bits = 0; free_bits <= STORAGE_SIZE; free_bits++) {
+            open_words[free_bits] = bank.openWords(free_bits);
+        }
+    }
 
-    using CircuitInitialization = std::tuple<
-        /* subcircuit schematic */ std::weak_ptr<CircuitSchematic>,
-        /* subcircuit name in parent */ std::string,
-        /* circuit */ std::shared_ptr<Circuit>,
-        /* parent circuit */ std::shared_ptr<Circuit>>;
+    /// @brief Lend `count` runs of bit_count bits, picking words best fit like DataBank::lendBools()
+    void lend(size_t bit_count, size_t count = 1)
+    {
+        while (count > 0) {
+            size_t free_bits = bit_count > 0 ? bit_count : 1;
+            while (free_bits <= STORAGE_SIZE && open_words[free_bits] == 0) {
+                free_bits++;
+            }
+            if (free_bits > STORAGE_SIZE) {
+                new_words++;
+                free_bits = STORAGE_SIZE;
+            } else {
+                open_words[free_bits]--;
+            }
+            // The word stays the best fit for runs of the same size until it is too full for them
+            const size_t fitting = bit_count > 0 ? std::min(count, free_bits / bit_count) : count;
+            count -= fitting;
+            if (free_bits - fitting * bit_count > 0) {
+                open_words[free_bits - fitting * bit_count]++;
+            }
+        }
+    }
+};
 
-    using CircuitConstruction = std::tuple<
-        /* subcircuit schematic */ std::weak_ptr<CircuitSchematic>,
-        /* subcircuit name in parent */ std::string,
-        /* parent circuit pointer */ std::weak_ptr<Circuit>>;
+void CircuitSchematic::estimateBuild(const Layout& layout, const BuildOptions& options, std::array<BankEstimate, 5>& banks, size_t& bytes)
+{
+    // The same lends as lateGenerate, in the same order
+    const size_t gate_counts[] = { layout.and_count, layout.not_count, layout.or_count, layout.xor_count };
+    for (size_t kind = 0; kind < 4; kind++) {
+        banks[kind + 1].lend(1, gate_counts[kind]);
+    }
+    for (size_t kind = 0; kind < 4; kind++) {
+        for (const auto& array : layout.gate_arrays[kind]) {
+            banks[kind + 1].lend(array.size);
+        }
+    }
+    for (size_t i = 0; i < layout.bridges.size(); i++) {
+        const auto& bridge = layout.bridges[options.place_gates ? layout.placed_bridges[i] : i];
+        if (!options.coalesce_sockets || !bridge.coalescible) {
+            banks[0].lend(bridge.width);
+        }
+    }
 
-    std::stack<CircuitInitialization> circuit_stack;
-    std::queue<CircuitConstruction> circuit_queue;
-    auto fake_parent = std::make_shared<Circuit>();
-    auto circuit = earlyGenerate();
+    size_t socket_count = layout.connections.size();
+    if (options.coalesce_sockets) {
+        socket_count -= std::count(layout.coalescible_connections.begin(), layout.coalescible_connections.end(), true);
+    }
+    bytes += socket_count * (sizeof(SocketController::Socket) + sizeof(SocketController::Transfer));
+    bytes += (layout.ports->slotCount() + layout.exposed->slotCount()) * sizeof(StorageHandle);
+    bytes += sizeof(Circuit) + layout.sub_export_slots.size() * sizeof(std::shared_ptr<Circuit>);
+}
 
-    for (const auto& [name, schematic] : sub_circuits) {
-        circuit_queue.push({ schematic, name, circuit });
+std::shared_ptr<Circuit> CircuitSchematic::build(Managers& managers, const BuildOptions& options)
+{
+    struct Instance {
+        std::shared_ptr<CircuitSchematic> schematic;
+        std::shared_ptr<const Layout> layout;
+        std::shared_ptr<Circuit> circuit;
+        /// The index of the parent instance and the slots the exposed ports take in its circuit
+        size_t parent;
+        const std::vector<uint32_t>* export_slots;
+    };
+
+    // Resolve the circuit tree breadth first, every schematic resolves its layout only once
+    auto root = self.lock();
+    std::vector<Instance> instances { { root, getLayout(), nullptr, 0, nullptr } };
+    for (size_t i = 0; i < instances.size(); i++) {
+        auto schematic = instances[i].schematic;
+        auto layout = instances[i].layout;
+        for (size_t j = 0; j < schematic->sub_circuits.size(); j++) {
+            auto sub_schematic = std::get<1>(schematic->sub_circuits[j]).lock();
+            if (!sub_schematic) {
+                throw std::runtime_error("Circuit schematic or parent circuit is expired");
+            }
+            instances.push_back({ sub_schematic, sub_schematic->getLayout(), nullptr, i, &layout->sub_export_slots[j] });
+        }
     }
-    circuit_stack.push({ self, "main", circuit, fake_parent });
 
-    while (!circuit_queue.empty()) {
-        auto [w_schematic, name, w_parent] = circuit_queue.front();
-        auto parent = w_parent.lock();
-        auto schematic = w_schematic.lock();
-        if (!schematic || !parent) {
-            throw std::runtime_error("Circuit schematic or parent circuit is expired");
+    // Check the budget before anything is allocated for the circuits
+    if (options.memory_budget > 0) {
+        std::array<BankEstimate, 5> banks { BankEstimate(*managers.random_access_data_bank), BankEstimate(managers.andGate->getDataBank()),
+            BankEstimate(managers.notGate->getDataBank()), BankEstimate(managers.orGate->getDataBank()), BankEstimate(managers.xorGate->getDataBank()) };
+        size_t bytes = 0;
+        for (auto it = instances.rbegin(); it != instances.rend(); ++it) {
+            estimateBuild(*it->layout, options, banks, bytes);
+        }
+        // The banks grow by whole chunks of words in every dimension
+        const size_t dimensions[] = { 1, 3, 2, 3, 3 };
+        for (size_t bank = 0; bank < banks.size(); bank++) {
+            const size_t words = banks[bank].words + banks[bank].new_words;
+            const size_t new_chunks = (words + StorageArena::CHUNK_SIZE - 1) / StorageArena::CHUNK_SIZE - (banks[bank].words + StorageArena::CHUNK_SIZE - 1) / StorageArena::CHUNK_SIZE;
+            bytes += new_chunks * StorageArena::CHUNK_SIZE * dimensions[bank] * sizeof(BoolStorage);
         }
-        circuit_queue.pop();
-        auto sub_circuit = schematic->earlyGenerate();
-        parent->sub_circuits.push_back(sub_circuit);
-        for (const auto& [sub_name, sub_schematic] : schematic->sub_circuits) {
-            CircuitConstruction cc = { sub_schematic, sub_name, sub_circuit };
-            circuit_queue.push(cc);
+        const size_t held = MemoryReport(managers).total();
+        if (held + bytes > options.memory_budget) {
+            throw std::runtime_error("Building " + name + " needs about " + std::to_string(held + bytes) + " bytes, over the memory budget of " + std::to_string(options.memory_budget));
         }
-        circuit_stack.push({ w_schematic, name, sub_circuit, parent });
     }
 
-    while (!circuit_stack.empty()) {
-        auto [w_schematic, name_in_parent, circuit, parent] = circuit_stack.top();
-        auto schematic = w_schematic.lock();
-        if (!schematic) {
-            throw std::runtime_error("Circuit schematic or parent circuit is expired");
+    for (size_t i = 0; i < instances.size(); i++) {
+        instances[i].circuit = earlyGenerate(*instances[i].layout, managers);
+        if (i > 0) {
+            instances[instances[i].parent].circuit->sub_circuits.push_back(instances[i].circuit);
         }
-        circuit_stack.pop();
-        schematic->lateGenerate(circuit, managers, parent, name_in_parent);
     }
 
-    // lateGenerate(circuit, managers, fake_parent, "main");
+    // Lend the storage deepest circuits first
+    for (auto it = instances.rbegin(); it != instances.rend(); ++it) {
+        Circuit* parent = it == instances.rend() - 1 ? nullptr : instances[it->parent].circuit.get();
+        lateGenerate(*it->circuit, *it->layout, managers, parent, it->export_slots, options);
+    }
 
-    return circuit;
-}
\ No newline at end of file
+    return instances.front().circuit;
+}
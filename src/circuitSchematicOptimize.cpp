@@ -0,0 +1,457 @@
+#include "circuitSchematic.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+enum class GateKind { And, Not, Or, Xor };
+
+struct Gate {
+    GateKind kind;
+    std::string name;
+    std::vector<std::string> inputs;
+    std::string output;
+    bool live = false;
+};
+
+enum class PortKind { GateInput, GateOutput, Bridge, Opaque };
+
+struct PortInfo {
+    PortKind kind = PortKind::Opaque;
+    /// The index of the gate or bridge the port belongs to
+    size_t owner = 0;
+    /// Roots are read or written from outside the schematic and keep everything they depend on
+    bool root = false;
+    std::vector<std::string> drivers;
+};
+
+/// @brief What a port reads once the schematic settled: a constant or the value of a port
+struct Signal {
+    int constant;
+    std::string port;
+
+    static Signal of(std::string port) { return { -1, std::move(port) }; }
+    static Signal zero() { return { 0, {} }; }
+    bool isConstant() const { return constant >= 0; }
+    bool operator==(const Signal& other) const { return constant == other.constant && port == other.port; }
+    std::string key() const { return isConstant() ? std::to_string(constant) : "p" + port; }
+};
+
+class Optimizer {
+public:
+    std::vector<Gate> gates;
+    std::vector<bool> live_bridges;
+    std::vector<std::vector<std::string>> bridge_ports;
+    std::unordered_map<std::string, PortInfo> ports;
+    std::vector<std::pair<std::string, std::string>> connections;
+
+    void addGate(GateKind kind, const std::string& name)
+    {
+        Gate gate { kind, name, { name + "_a" }, name + "_b" };
+        if (kind != GateKind::Not) {
+            gate.inputs.push_back(name + "_b");
+            gate.output = name + "_c";
+        }
+        for (const auto& input : gate.inputs) {
+            ports[input] = { PortKind::GateInput, gates.size(), false, {} };
+        }
+        ports[gate.output] = { PortKind::GateOutput, gates.size(), false, {} };
+        gates.push_back(std::move(gate));
+    }
+
+    void addBridge(const CircuitSchematic::Bridge& bridge)
+    {
+        bridge_ports.emplace_back();
+        for (const auto& view : bridge) {
+            for (size_t i = 0; i < view.port_sizes.size(); i++) {
+                const std::string port = view.name + "_" + std::to_string(i);
+                // Views of a bridge share bits, writing through one view changes the others
+                ports[port] = { PortKind::Bridge, live_bridges.size(), bridge.size() > 1, {} };
+                bridge_ports.back().push_back(port);
+            }
+        }
+        live_bridges.push_back(false);
+    }
+
+    /// @brief Ports the optimizer knows nothing about, like the ports of sub-circuits
+    PortInfo& port(const std::string& name)
+    {
+        auto [it, inserted] = ports.try_emplace(name);
+        if (inserted) {
+            it->second.root = true;
+        }
+        return it->second;
+    }
+
+    /// @brief Get the output of a gate without inputs settling to a constant.
+    /// Reuses such a gate if there is one, so optimizing again does not add another.
+    std::string constantSource(int value)
+    {
+        const GateKind kind = value ? GateKind::Not : GateKind::And;
+        for (const auto& gate : gates) {
+            auto undriven = [&](const std::string& port) {
+                const PortInfo& info = ports.at(port);
+                return info.drivers.empty() && !info.root;
+            };
+            if (gate.kind == kind && undriven(gate.output) && std::all_of(gate.inputs.begin(), gate.inputs.end(), undriven)) {
+                return gate.output;
+            }
+        }
+        std::string name = value ? "$one" : "$zero";
+        while (ports.count(name + "_a") || ports.count(name + "_b") || ports.count(name + "_c")) {
+            name += "$";
+        }
+        addGate(kind, name);
+        return gates.back().output;
+    }
+
+    /// @brief Compute the signals of every port a port depends on, then of the port itself
+    const Signal& evaluate(const std::string& start)
+    {
+        if (auto it = signals.find(start); it != signals.end()) {
+            return it->second;
+        }
+        // An explicit stack, long chains of gates would overflow the call stack
+        std::vector<std::pair<std::string, bool>> stack { { start, false } };
+        std::unordered_set<std::string> active;
+        while (!stack.empty()) {
+            const std::string name = stack.back().first;
+            if (signals.count(name)) {
+                stack.pop_back();
+                continue;
+            }
+            if (!stack.back().second) {
+                stack.back().second = true;
+                active.insert(name);
+                for (const auto& dependency : dependencies(name)) {
+                    if (!signals.count(dependency) && !active.count(dependency)) {
+                        stack.push_back({ dependency, false });
+                    }
+                }
+                continue;
+            }
+            stack.pop_back();
+            active.erase(name);
+            signals[name] = compute(name);
+        }
+        return signals.at(start);
+    }
+
+private:
+    std::unordered_map<std::string, Signal> signals;
+    /// @brief Structural hashes of the kept gates, by kind and input signals
+    std::unordered_map<std::string, std::string> hashed;
+
+    std::vector<std::string> dependencies(const std::string& name) const
+    {
+        const PortInfo& info = ports.at(name);
+        switch (info.kind) {
+        case PortKind::GateOutput:
+            return info.drivers.empty() ? gates[info.owner].inputs : std::vector<std::string> {};
+        case PortKind::GateInput:
+        case PortKind::Bridge:
+            return info.drivers.size() == 1 ? info.drivers : std::vector<std::string> {};
+        default:
+            return {};
+        }
+    }
+
+    /// @brief The signal of a port, a port still being evaluated is part of a loop and reads itself
+    Signal get(const std::string& name) const
+    {
+        auto it = signals.find(name);
+        return it == signals.end() ? Signal::of(name) : it->second;
+    }
+
+    Signal compute(const std::string& name)
+    {
+        const PortInfo& info = ports.at(name);
+        switch (info.kind) {
+        case PortKind::GateInput:
+        case PortKind::Bridge:
+            if (info.kind == PortKind::Bridge && info.root) {
+                return Signal::of(name);
+            }
+            if (info.drivers.size() == 1) {
+                return get(info.drivers[0]);
+            }
+            return info.drivers.empty() && !info.root ? Signal::zero() : Signal::of(name);
+        case PortKind::GateOutput:
+            return info.drivers.empty() ? gateSignal(gates[info.owner]) : Signal::of(name);
+        default:
+            return Signal::of(name);
+        }
+    }
+
+    /// @brief The NOT gate driving a signal, if its input is known and not part of a loop
+    const Gate* notGate(const Signal& signal) const
+    {
+        if (signal.isConstant()) {
+            return nullptr;
+        }
+        const PortInfo& info = ports.at(signal.port);
+        if (info.kind != PortKind::GateOutput || !info.drivers.empty() || gates[info.owner].kind != GateKind::Not) {
+            return nullptr;
+        }
+        const Gate& gate = gates[info.owner];
+        return signals.count(gate.inputs[0]) ? &gate : nullptr;
+    }
+
+    Signal gateSignal(const Gate& gate)
+    {
+        std::vector<Signal> inputs;
+        for (const auto& input : gate.inputs) {
+            inputs.push_back(get(input));
+        }
+
+        if (gate.kind == GateKind::Not) {
+            if (inputs[0].isConstant()) {
+                return { 1 - inputs[0].constant, {} };
+            }
+            if (const Gate* inner = notGate(inputs[0])) {
+                return get(inner->inputs[0]);
+            }
+            return hash(gate, inputs);
+        }
+
+        if (gate.kind == GateKind::Xor) {
+            int parity = 0;
+            std::vector<Signal> rest;
+            for (const auto& input : inputs) {
+                if (input.isConstant()) {
+                    parity ^= input.constant;
+                } else if (auto it = std::find(rest.begin(), rest.end(), input); it != rest.end()) {
+                    rest.erase(it);
+                } else {
+                    rest.push_back(input);
+                }
+            }
+            if (rest.empty()) {
+                return { parity, {} };
+            }
+            if (rest.size() == 1 && parity == 0) {
+                return rest[0];
+            }
+            if (rest.size() == 1) {
+                if (const Gate* inner = notGate(rest[0])) {
+                    return get(inner->inputs[0]);
+                }
+            }
+            return hash(gate, inputs);
+        }
+
+        const int absorbing = gate.kind == GateKind::And ? 0 : 1;
+        std::vector<Signal> rest;
+        for (const auto& input : inputs) {
+            if (input.constant == absorbing) {
+                return { absorbing, {} };
+            }
+            if (!input.isConstant() && std::find(rest.begin(), rest.end(), input) == rest.end()) {
+                rest.push_back(input);
+            }
+        }
+        if (rest.empty()) {
+            return { 1 - absorbing, {} };
+        }
+        if (rest.size() == 1) {
+            return rest[0];
+        }
+        return hash(gate, inputs);
+    }
+
+    /// @brief The output of the first gate computing the same function of the same signals
+    Signal hash(const Gate& gate, const std::vector<Signal>& inputs)
+    {
+        std::vector<std::string> keys;
+        for (const auto& input : inputs) {
+            keys.push_back(input.key());
+        }
+        // All gate kinds are commutative
+        std::sort(keys.begin(), keys.end());
+        std::string key(1, static_cast<char>('0' + static_cast<int>(gate.kind)));
+        for (const auto& input : keys) {
+            key += '\n';
+            key += input;
+        }
+        auto [it, inserted] = hashed.try_emplace(key, gate.output);
+        return Signal::of(it->second);
+    }
+};
+
+}
+
+CircuitSchematic::OptimizationStats CircuitSchematic::optimize()
+{
+    // Shared sub-circuit schematics are optimized once
+    std::vector<std::shared_ptr<CircuitSchematic>> schematics { self.lock() };
+    std::unordered_set<CircuitSchematic*> visited { this };
+    for (size_t i = 0; i < schematics.size(); i++) {
+        for (const auto& [sub_name, w_sub_schematic] : schematics[i]->sub_circuits) {
+            auto sub_schematic = w_sub_schematic.lock();
+            if (!sub_schematic) {
+                throw std::runtime_error("Circuit schematic or parent circuit is expired");
+            }
+            if (visited.insert(sub_schematic.get()).second) {
+                schematics.push_back(sub_schematic);
+            }
+        }
+    }
+
+    OptimizationStats total;
+    for (const auto& schematic : schematics) {
+        const auto stats = schematic->optimizeSchematic();
+        total.removed_gates += stats.removed_gates;
+        total.removed_bridges += stats.removed_bridges;
+        total.removed_connections += stats.removed_connections;
+    }
+    return total;
+}
+
+CircuitSchematic::OptimizationStats CircuitSchematic::optimizeSchematic()
+{
+    Optimizer optimizer;
+    const std::vector<std::string>* gate_lists[] = { &and_gates, &not_gates, &or_gates, &xor_gates };
+    const GateKind kinds[] = { GateKind::And, GateKind::Not, GateKind::Or, GateKind::Xor };
+    for (size_t i = 0; i < 4; i++) {
+        for (const auto& gate : *gate_lists[i]) {
+            optimizer.addGate(kinds[i], gate);
+        }
+    }
+    const size_t gate_count = optimizer.gates.size();
+    for (const auto& bridge : wire_bridges) {
+        optimizer.addBridge(bridge);
+    }
+    for (const auto& [sub_name, w_sub_schematic] : sub_circuits) {
+        auto sub_schematic = w_sub_schematic.lock();
+        if (!sub_schematic) {
+            throw std::runtime_error("Circuit schematic or parent circuit is expired");
+        }
+        for (const auto& exposed_port : sub_schematic->exposed_ports) {
+            optimizer.port(sub_name + "_" + exposed_port).root = true;
+        }
+    }
+    for (const auto& exposed_port : exposed_ports) {
+        optimizer.port(resolveAlias(exposed_port)).root = true;
+    }
+    for (const auto& [from, to] : connections) {
+        const std::string base_from = resolveAlias(from);
+        const std::string base_to = resolveAlias(to);
+        optimizer.port(base_from);
+        optimizer.port(base_to).drivers.push_back(base_from);
+        optimizer.connections.push_back({ base_from, base_to });
+    }
+    const std::string constants[] = { optimizer.constantSource(0), optimizer.constantSource(1) };
+
+    // Let every connection read the simplest port with the same settled value
+    std::vector<std::pair<std::string, std::string>> rewritten;
+    std::unordered_map<std::string, std::vector<std::string>> drivers;
+    for (const auto& [from, to] : optimizer.connections) {
+        const PortInfo& target = optimizer.ports.at(to);
+        Signal signal = optimizer.evaluate(from);
+        // Several drivers overwrite each other in order
+        if (target.drivers.size() > 1) {
+            signal = Signal::of(from);
+        }
+        // Undriven inputs read 0 without a connection, unless they are roots and could be written from outside.
+        // Gate outputs hold what their gate computed, a connection of 0 still has to overwrite them
+        const bool reads_zero = target.kind == PortKind::GateInput || target.kind == PortKind::Bridge;
+        if ((signal.constant == 0 && reads_zero && !target.root) || signal.port == to) {
+            continue;
+        }
+        const std::string source = signal.isConstant() ? constants[signal.constant] : signal.port;
+        rewritten.push_back({ source, to });
+        drivers[to].push_back(source);
+    }
+
+    // Keep what the roots depend on
+    std::vector<std::string> pending;
+    std::unordered_set<std::string> live;
+    auto mark = [&](const std::string& port) {
+        if (live.insert(port).second) {
+            pending.push_back(port);
+        }
+    };
+    for (const auto& [port, info] : optimizer.ports) {
+        if (info.root) {
+            mark(port);
+        }
+    }
+    while (!pending.empty()) {
+        const std::string port = pending.back();
+        pending.pop_back();
+        const PortInfo& info = optimizer.ports.at(port);
+        if (info.kind == PortKind::GateInput || info.kind == PortKind::GateOutput) {
+            Gate& gate = optimizer.gates[info.owner];
+            if (!gate.live) {
+                gate.live = true;
+                for (const auto& input : gate.inputs) {
+                    mark(input);
+                }
+                mark(gate.output);
+            }
+        } else if (info.kind == PortKind::Bridge && !optimizer.live_bridges[info.owner]) {
+            optimizer.live_bridges[info.owner] = true;
+            for (const auto& bridge_port : optimizer.bridge_ports[info.owner]) {
+                mark(bridge_port);
+            }
+        }
+        if (auto it = drivers.find(port); it != drivers.end()) {
+            for (const auto& driver : it->second) {
+                mark(driver);
+            }
+        }
+    }
+
+    OptimizationStats stats;
+    const size_t connection_count = connections.size();
+    size_t gate = 0;
+    auto keepGates = [&](std::vector<std::string>& names) {
+        std::vector<std::string> kept;
+        for (auto& name : names) {
+            if (optimizer.gates[gate++].live) {
+                kept.push_back(std::move(name));
+            }
+        }
+        names = std::move(kept);
+    };
+    for (auto* gates : { &and_gates, &not_gates, &or_gates, &xor_gates }) {
+        keepGates(*gates);
+    }
+    stats.removed_gates = gate_count - and_gates.size() - not_gates.size() - or_gates.size() - xor_gates.size();
+    for (; gate < optimizer.gates.size(); gate++) {
+        if (optimizer.gates[gate].live) {
+            (optimizer.gates[gate].kind == GateKind::Not ? not_gates : and_gates).push_back(optimizer.gates[gate].name);
+        }
+    }
+
+    std::vector<Bridge> kept_bridges;
+    for (size_t i = 0; i < wire_bridges.size(); i++) {
+        if (optimizer.live_bridges[i]) {
+            kept_bridges.push_back(std::move(wire_bridges[i]));
+        }
+    }
+    stats.removed_bridges = wire_bridges.size() - kept_bridges.size();
+    wire_bridges = std::move(kept_bridges);
+
+    connections.clear();
+    for (const auto& [from, to] : rewritten) {
+        if (live.count(to)) {
+            connections.push_back({ from, to });
+        }
+    }
+    stats.removed_connections = connection_count - std::min(connection_count, connections.size());
+
+    std::vector<std::string> dead_aliases;
+    for (const auto& [alias, target] : aliases) {
+        const std::string base_target = resolveAlias(target);
+        if (optimizer.ports.count(base_target) && !live.count(base_target)) {
+            dead_aliases.push_back(alias);
+        }
+    }
+    for (const auto& alias : dead_aliases) {
+        aliases.erase(alias);
+    }
+    modified();
+    return stats;
+}
@@ -0,0 +1,215 @@
+#include "eventScheduler.hpp"
+#include "managers.hpp"
+
+std::vector<size_t> EventScheduler::computeSignature(Managers& managers) const
+{
+    return {
+        managers.andGate->getDataBank().size(),
+        managers.notGate->getDataBank().size(),
+        managers.orGate->getDataBank().size(),
+        managers.xorGate->getDataBank().size(),
+        managers.socketController->getSockets().size(),
+    };
+}
+
+uint32_t EventScheduler::wordId(BoolStorage* word)
+{
+    auto [it, inserted] = word_ids.emplace(word, static_cast<uint32_t>(words.size()));
+    if (inserted) {
+        words.push_back(word);
+        shadow.push_back(*word);
+        word_gate.push_back(NONE);
+    }
+    return it->second;
+}
+
+void EventScheduler::compile(Managers& managers)
+{
+    signature = computeSignature(managers);
+    words.clear();
+    shadow.clear();
+    word_ids.clear();
+    gate_ops.clear();
+    word_gate.clear();
+
+    auto addBank = [&](DataBank<3>& bank, GateKind kind) {
+        for (size_t i = 0; i < bank.size(); i++) {
+            GateOp op { kind, wordId(&bank.word(0, i)), wordId(&bank.word(1, i)), wordId(&bank.word(2, i)) };
+            word_gate[op.a] = word_gate[op.b] = word_gate[op.c] = static_cast<uint32_t>(gate_ops.size());
+            gate_ops.push_back(op);
+        }
+    };
+    addBank(managers.andGate->getDataBank(), GateKind::And);
+    DataBank<2>& not_bank = managers.notGate->getDataBank();
+    for (size_t i = 0; i < not_bank.size(); i++) {
+        const uint32_t a = wordId(&not_bank.word(0, i));
+        GateOp op { GateKind::Not, a, a, wordId(&not_bank.word(1, i)) };
+        word_gate[op.a] = word_gate[op.c] = static_cast<uint32_t>(gate_ops.size());
+        gate_ops.push_back(op);
+    }
+    addBank(managers.orGate->getDataBank(), GateKind::Or);
+    addBank(managers.xorGate->getDataBank(), GateKind::Xor);
+
+    transfers = managers.socketController->getPlan();
+    transfer_from.resize(transfers.size());
+    transfer_to.resize(transfers.size());
+    for (size_t i = 0; i < transfers.size(); i++) {
+        transfer_from[i] = wordId(transfers[i].from);
+        transfer_to[i] = wordId(transfers[i].to);
+    }
+
+    // Group the readers of each word, keeping them in plan order
+    reader_offsets.assign(words.size() + 1, 0);
+    for (size_t i = 0; i < transfers.size(); i++) {
+        reader_offsets[transfer_from[i] + 1]++;
+        if (transfer_to[i] != transfer_from[i]) {
+            reader_offsets[transfer_to[i] + 1]++;
+        }
+    }
+    for (size_t i = 0; i < words.size(); i++) {
+        reader_offsets[i + 1] += reader_offsets[i];
+    }
+    readers.resize(reader_offsets.back());
+    std::vector<uint32_t> fill(reader_offsets.begin(), reader_offsets.end() - 1);
+    for (uint32_t i = 0; i < transfers.size(); i++) {
+        readers[fill[transfer_from[i]]++] = i;
+        if (transfer_to[i] != transfer_from[i]) {
+            readers[fill[transfer_to[i]]++] = i;
+        }
+    }
+
+    // Nothing has been evaluated yet, so the first tick is a full sweep
+    gate_pending.assign(gate_ops.size(), 1);
+    gate_queue.resize(gate_ops.size());
+    for (uint32_t i = 0; i < gate_ops.size(); i++) {
+        gate_queue[i] = i;
+    }
+    transfer_now.assign(transfers.size(), 0);
+    transfer_next.assign(transfers.size(), 1);
+    transfer_queue_next.resize(transfers.size());
+    for (uint32_t i = 0; i < transfers.size(); i++) {
+        transfer_queue_next[i] = i;
+    }
+    transfer_heap = {};
+}
+
+void EventScheduler::scheduleGate(uint32_t gate)
+{
+    if (!gate_pending[gate]) {
+        gate_pending[gate] = 1;
+        gate_queue.push_back(gate);
+    }
+}
+
+void EventScheduler::wordChanged(uint32_t word, Phase phase, uint32_t source)
+{
+    const uint32_t gate = word_gate[word];
+    // A gate does not need to re-evaluate because of its own output
+    if (gate != NONE && !(phase == Phase::Gates && gate == source)) {
+        scheduleGate(gate);
+    }
+
+    for (uint32_t i = reader_offsets[word]; i < reader_offsets[word + 1]; i++) {
+        const uint32_t transfer = readers[i];
+        // Transfers later in the plan see the change during this tick, earlier ones during the next tick.
+        // Re-running the transfer that made the change is a no-op unless it reads its own destination word.
+        if (phase != Phase::Sockets || transfer > source) {
+            if (!transfer_now[transfer]) {
+                transfer_now[transfer] = 1;
+                transfer_heap.push(transfer);
+            }
+        } else if (transfer < source || transfer_from[transfer] == transfer_to[transfer]) {
+            if (!transfer_next[transfer]) {
+                transfer_next[transfer] = 1;
+                transfer_queue_next.push_back(transfer);
+            }
+        }
+    }
+}
+
+void EventScheduler::evaluateGate(uint32_t gate)
+{
+    const GateOp& op = gate_ops[gate];
+    BoolStorage& c = *words[op.c];
+    const BoolStorage previous = c;
+    switch (op.kind) {
+    case GateKind::And:
+        c = *words[op.a] & *words[op.b];
+        break;
+    case GateKind::Not:
+        c = ~*words[op.a];
+        break;
+    case GateKind::Or:
+        c = *words[op.a] | *words[op.b];
+        break;
+    case GateKind::Xor:
+        c = *words[op.a] ^ *words[op.b];
+        break;
+    }
+    if (c != previous) {
+        shadow[op.c] = c;
+        wordChanged(op.c, Phase::Gates, gate);
+    }
+}
+
+void EventScheduler::notifyWrite(const BoolStorageAccessor& accessor)
+{
+    auto it = word_ids.find(accessor.getBuffer().get());
+    if (it == word_ids.end()) {
+        return;
+    }
+    shadow[it->second] = *words[it->second];
+    wordChanged(it->second, Phase::External, NONE);
+}
+
+void EventScheduler::tick(Managers& managers)
+{
+    if (signature != computeSignature(managers)) {
+        compile(managers);
+    }
+    activity = {};
+
+    // Transfers that were affected by changes late in the previous tick
+    for (uint32_t transfer : transfer_queue_next) {
+        transfer_next[transfer] = 0;
+        if (!transfer_now[transfer]) {
+            transfer_now[transfer] = 1;
+            transfer_heap.push(transfer);
+        }
+    }
+    transfer_queue_next.clear();
+
+    if (detect_external_writes) {
+        for (uint32_t word = 0; word < words.size(); word++) {
+            if (*words[word] != shadow[word]) {
+                shadow[word] = *words[word];
+                wordChanged(word, Phase::External, NONE);
+            }
+        }
+    }
+
+    // Gate phase, gates scheduled from here on are evaluated during the next tick
+    gate_work.clear();
+    gate_work.swap(gate_queue);
+    for (uint32_t gate : gate_work) {
+        gate_pending[gate] = 0;
+        evaluateGate(gate);
+    }
+    activity.gate_words = gate_work.size();
+
+    // Socket phase, in plan order
+    while (!transfer_heap.empty()) {
+        const uint32_t transfer = transfer_heap.top();
+        transfer_heap.pop();
+        transfer_now[transfer] = 0;
+
+        BoolStorage& to = *words[transfer_to[transfer]];
+        const BoolStorage previous = to;
+        transfers[transfer].apply();
+        activity.transfers++;
+        if (to != previous) {
+            shadow[transfer_to[transfer]] = to;
+            wordChanged(transfer_to[transfer], Phase::Sockets, transfer);
+        }
+    }
+}
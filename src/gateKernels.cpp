@@ -0,0 +1,209 @@
+#include "gates/gateKernels.hpp"
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CIRCUITSIM_X86_KERNELS
+#endif
+
+// Storage words are processed as raw 64-bit lanes. The alias attribute makes reading
+// a BoolStorage through these pointers well defined.
+typedef uint64_t __attribute__((may_alias)) Lane;
+
+static_assert(sizeof(BoolStorage) % sizeof(uint64_t) == 0, "BoolStorage must be made of 64-bit lanes");
+constexpr size_t LANES_PER_WORD = sizeof(BoolStorage) / sizeof(uint64_t);
+
+namespace {
+
+struct BinaryAnd {
+    static uint64_t apply(uint64_t a, uint64_t b) { return a & b; }
+};
+struct BinaryOr {
+    static uint64_t apply(uint64_t a, uint64_t b) { return a | b; }
+};
+struct BinaryXor {
+    static uint64_t apply(uint64_t a, uint64_t b) { return a ^ b; }
+};
+
+template <typename Op>
+void scalarBinary(const Lane* a, const Lane* b, Lane* c, size_t lanes)
+{
+    for (size_t i = 0; i < lanes; i++) {
+        c[i] = Op::apply(a[i], b[i]);
+    }
+}
+
+void scalarNot(const Lane* a, Lane* b, size_t lanes)
+{
+    for (size_t i = 0; i < lanes; i++) {
+        b[i] = ~a[i];
+    }
+}
+
+#ifdef CIRCUITSIM_X86_KERNELS
+
+__attribute__((target("avx2"))) __m256i avx2Apply(BinaryAnd, __m256i a, __m256i b) { return _mm256_and_si256(a, b); }
+__attribute__((target("avx2"))) __m256i avx2Apply(BinaryOr, __m256i a, __m256i b) { return _mm256_or_si256(a, b); }
+__attribute__((target("avx2"))) __m256i avx2Apply(BinaryXor, __m256i a, __m256i b) { return _mm256_xor_si256(a, b); }
+
+template <typename Op>
+__attribute__((target("avx2"))) void avx2Binary(const Lane* a, const Lane* b, Lane* c, size_t lanes)
+{
+    size_t i = 0;
+    for (; i + 4 <= lanes; i += 4) {
+        const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(c + i), avx2Apply(Op {}, va, vb));
+    }
+    scalarBinary<Op>(a + i, b + i, c + i, lanes - i);
+}
+
+__attribute__((target("avx2"))) void avx2Not(const Lane* a, Lane* b, size_t lanes)
+{
+    const __m256i ones = _mm256_set1_epi64x(-1);
+    size_t i = 0;
+    for (; i + 4 <= lanes; i += 4) {
+        const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(b + i), _mm256_xor_si256(va, ones));
+    }
+    scalarNot(a + i, b + i, lanes - i);
+}
+
+__attribute__((target("avx512f"))) __m512i avx512Apply(BinaryAnd, __m512i a, __m512i b) { return _mm512_and_si512(a, b); }
+__attribute__((target("avx512f"))) __m512i avx512Apply(BinaryOr, __m512i a, __m512i b) { return _mm512_or_si512(a, b); }
+__attribute__((target("avx512f"))) __m512i avx512Apply(BinaryXor, __m512i a, __m512i b) { return _mm512_xor_si512(a, b); }
+
+template <typename Op>
+__attribute__((target("avx512f"))) void avx512Binary(const Lane* a, const Lane* b, Lane* c, size_t lanes)
+{
+    size_t i = 0;
+    for (; i + 8 <= lanes; i += 8) {
+        const __m512i va = _mm512_loadu_si512(a + i);
+        const __m512i vb = _mm512_loadu_si512(b + i);
+        _mm512_storeu_si512(c + i, avx512Apply(Op {}, va, vb));
+    }
+    scalarBinary<Op>(a + i, b + i, c + i, lanes - i);
+}
+
+__attribute__((target("avx512f"))) void avx512Not(const Lane* a, Lane* b, size_t lanes)
+{
+    const __m512i ones = _mm512_set1_epi64(-1);
+    size_t i = 0;
+    for (; i + 8 <= lanes; i += 8) {
+        const __m512i va = _mm512_loadu_si512(a + i);
+        _mm512_storeu_si512(b + i, _mm512_xor_si512(va, ones));
+    }
+    scalarNot(a + i, b + i, lanes - i);
+}
+
+#endif
+
+using BinaryKernel = void (*)(const Lane*, const Lane*, Lane*, size_t);
+using UnaryKernel = void (*)(const Lane*, Lane*, size_t);
+
+struct KernelTable {
+    KernelIsa isa;
+    BinaryKernel and_kernel;
+    BinaryKernel or_kernel;
+    BinaryKernel xor_kernel;
+    UnaryKernel not_kernel;
+};
+
+/// @brief The kernels of an instruction set, the tables live as long as the program
+const KernelTable* kernelTable(KernelIsa isa)
+{
+    static const KernelTable scalar { KernelIsa::Scalar, scalarBinary<BinaryAnd>, scalarBinary<BinaryOr>, scalarBinary<BinaryXor>, scalarNot };
+#ifdef CIRCUITSIM_X86_KERNELS
+    static const KernelTable avx2 { KernelIsa::Avx2, avx2Binary<BinaryAnd>, avx2Binary<BinaryOr>, avx2Binary<BinaryXor>, avx2Not };
+    static const KernelTable avx512 { KernelIsa::Avx512, avx512Binary<BinaryAnd>, avx512Binary<BinaryOr>, avx512Binary<BinaryXor>, avx512Not };
+#endif
+    switch (isa) {
+#ifdef CIRCUITSIM_X86_KERNELS
+    case KernelIsa::Avx512:
+        return &avx512;
+    case KernelIsa::Avx2:
+        return &avx2;
+#endif
+    default:
+        return &scalar;
+    }
+}
+
+bool isSupported(KernelIsa isa)
+{
+    switch (isa) {
+    case KernelIsa::Scalar:
+        return true;
+#ifdef CIRCUITSIM_X86_KERNELS
+    case KernelIsa::Avx2:
+        return __builtin_cpu_supports("avx2");
+    case KernelIsa::Avx512:
+        return __builtin_cpu_supports("avx512f");
+#endif
+    default:
+        return false;
+    }
+}
+
+/// @brief The table the kernels dispatch to. Swapped atomically, so setKernelIsa() may race with running ticks
+std::atomic<const KernelTable*>& activeTable()
+{
+    static std::atomic<const KernelTable*> table { kernelTable(detectKernelIsa()) };
+    return table;
+}
+
+const KernelTable& activeKernels()
+{
+    return *activeTable().load(std::memory_order_acquire);
+}
+
+const Lane* lanes(const BoolStorage* words) { return reinterpret_cast<const Lane*>(words); }
+Lane* lanes(BoolStorage* words) { return reinterpret_cast<Lane*>(words); }
+
+}
+
+KernelIsa detectKernelIsa()
+{
+    if (isSupported(KernelIsa::Avx512)) {
+        return KernelIsa::Avx512;
+    }
+    if (isSupported(KernelIsa::Avx2)) {
+        return KernelIsa::Avx2;
+    }
+    return KernelIsa::Scalar;
+}
+
+KernelIsa getKernelIsa()
+{
+    return activeKernels().isa;
+}
+
+void setKernelIsa(KernelIsa isa)
+{
+    if (!isSupported(isa)) {
+        throw std::runtime_error("Kernel instruction set is not supported by this CPU");
+    }
+    activeTable().store(kernelTable(isa), std::memory_order_release);
+}
+
+void andKernel(const BoolStorage* a, const BoolStorage* b, BoolStorage* c, size_t size)
+{
+    activeKernels().and_kernel(lanes(a), lanes(b), lanes(c), size * LANES_PER_WORD);
+}
+
+void orKernel(const BoolStorage* a, const BoolStorage* b, BoolStorage* c, size_t size)
+{
+    activeKernels().or_kernel(lanes(a), lanes(b), lanes(c), size * LANES_PER_WORD);
+}
+
+void xorKernel(const BoolStorage* a, const BoolStorage* b, BoolStorage* c, size_t size)
+{
+    activeKernels().xor_kernel(lanes(a), lanes(b), lanes(c), size * LANES_PER_WORD);
+}
+
+void notKernel(const BoolStorage* a, BoolStorage* b, size_t size)
+{
+    activeKernels().not_kernel(lanes(a), lanes(b), size * LANES_PER_WORD);
+}
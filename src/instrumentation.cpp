@@ -0,0 +1,117 @@
+#include "instrumentation.hpp"
+#include <atomic>
+
+namespace {
+
+std::atomic<uint64_t> accessor_locks { 0 };
+
+const char* const PHASE_NAMES[TICK_PHASE_COUNT] = { "and", "not", "or", "xor", "sockets" };
+
+void writeJsonStats(std::ostream& out, const TickStats& stats)
+{
+    out << "{\"tick\":" << stats.tick << ",\"cycles\":" << stats.cycles << ",\"accessor_locks\":" << stats.accessor_locks;
+    for (size_t i = 0; i < TICK_PHASE_COUNT; i++) {
+        const PhaseStats& phase = stats.phases[i];
+        out << ",\"" << PHASE_NAMES[i] << "\":{\"cycles\":" << phase.cycles << ",\"words\":" << phase.words
+            << ",\"bits_changed\":" << phase.bits_changed << "}";
+    }
+    out << "}";
+}
+
+}
+
+PhaseStats& PhaseStats::operator+=(const PhaseStats& other)
+{
+    cycles += other.cycles;
+    words += other.words;
+    bits_changed += other.bits_changed;
+    return *this;
+}
+
+PhaseStats PhaseStats::operator-(const PhaseStats& other) const
+{
+    return { cycles - other.cycles, words - other.words, bits_changed - other.bits_changed };
+}
+
+void countAccessorLock()
+{
+    accessor_locks.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t getAccessorLockCount()
+{
+    return accessor_locks.load(std::memory_order_relaxed);
+}
+
+void Instrumentation::beginTick(const PhaseSources& phases)
+{
+    for (size_t i = 0; i < TICK_PHASE_COUNT; i++) {
+        phases_start[i] = *phases[i];
+    }
+    locks_start = getAccessorLockCount();
+    tick_start = readCycleCounter();
+}
+
+void Instrumentation::endTick(const PhaseSources& phases)
+{
+    TickStats stats;
+    stats.cycles = readCycleCounter() - tick_start;
+    stats.accessor_locks = getAccessorLockCount() - locks_start;
+    stats.tick = totals.tick++;
+    totals.cycles += stats.cycles;
+    totals.accessor_locks += stats.accessor_locks;
+    for (size_t i = 0; i < TICK_PHASE_COUNT; i++) {
+        stats.phases[i] = *phases[i] - phases_start[i];
+        totals.phases[i] += stats.phases[i];
+    }
+
+    if (capacity == 0) {
+        return;
+    }
+    if (series.size() == capacity) {
+        series.pop_front();
+    }
+    series.push_back(stats);
+}
+
+void Instrumentation::setCapacity(size_t capacity)
+{
+    this->capacity = capacity;
+    while (series.size() > capacity) {
+        series.pop_front();
+    }
+}
+
+void Instrumentation::clear()
+{
+    series.clear();
+    totals = TickStats();
+}
+
+void Instrumentation::writeCsv(std::ostream& out) const
+{
+    out << "tick,cycles,accessor_locks";
+    for (const char* name : PHASE_NAMES) {
+        out << "," << name << "_cycles," << name << "_words," << name << "_bits_changed";
+    }
+    out << "\n";
+    for (const auto& stats : series) {
+        out << stats.tick << "," << stats.cycles << "," << stats.accessor_locks;
+        for (const auto& phase : stats.phases) {
+            out << "," << phase.cycles << "," << phase.words << "," << phase.bits_changed;
+        }
+        out << "\n";
+    }
+}
+
+void Instrumentation::writeJson(std::ostream& out) const
+{
+    out << "{\"totals\":";
+    writeJsonStats(out, totals);
+    out << ",\"series\":[";
+    for (size_t i = 0; i < series.size(); i++) {
+        out << (i ? "," : "");
+        writeJsonStats(out, series[i]);
+    }
+    out << "]}";
+}
@@ -0,0 +1,247 @@
+#include "levelizedScheduler.hpp"
+#include "managers.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+
+namespace {
+
+constexpr uint32_t NONE = UINT32_MAX;
+constexpr int32_t UNVISITED = -1;
+constexpr int32_t IN_PROGRESS = -2;
+
+/// @brief Compressed lists of values grouped by key
+struct Groups {
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> values;
+
+    template <typename ForEachPair>
+    void build(size_t key_count, ForEachPair forEachPair)
+    {
+        offsets.assign(key_count + 1, 0);
+        forEachPair([&](size_t key, uint32_t) { offsets[key + 1]++; });
+        for (size_t i = 0; i < key_count; i++) {
+            offsets[i + 1] += offsets[i];
+        }
+        values.resize(offsets.back());
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        forEachPair([&](size_t key, uint32_t value) { values[fill[key]++] = value; });
+    }
+};
+
+}
+
+std::vector<size_t> LevelizedScheduler::computeSignature(Managers& managers) const
+{
+    return {
+        managers.andGate->getDataBank().size(),
+        managers.notGate->getDataBank().size(),
+        managers.orGate->getDataBank().size(),
+        managers.xorGate->getDataBank().size(),
+        managers.socketController->getSockets().size(),
+    };
+}
+
+void LevelizedScheduler::compile(Managers& managers)
+{
+    signature.clear();
+    transfers = managers.socketController->getPlan();
+    stages.clear();
+
+    // Number every word, remembering which gate word drives the output words
+    struct GateWord {
+        uint8_t bank;
+        uint32_t index;
+        uint32_t a;
+        uint32_t b;
+    };
+    std::unordered_map<const BoolStorage*, uint32_t> word_ids;
+    std::vector<uint32_t> output_gate;
+    std::vector<GateWord> gate_words;
+    auto wordId = [&](const BoolStorage* word) {
+        auto [it, inserted] = word_ids.emplace(word, static_cast<uint32_t>(output_gate.size()));
+        if (inserted) {
+            output_gate.push_back(NONE);
+        }
+        return it->second;
+    };
+    auto addBank = [&](auto& bank, uint8_t bank_id) {
+        constexpr size_t output = std::tuple_size<typename std::remove_reference_t<decltype(bank)>::Span>::value - 1;
+        for (uint32_t i = 0; i < bank.size(); i++) {
+            const uint32_t a = wordId(&bank.word(0, i));
+            const uint32_t b = wordId(&bank.word(output == 2 ? 1 : 0, i));
+            output_gate[wordId(&bank.word(output, i))] = static_cast<uint32_t>(gate_words.size());
+            gate_words.push_back({ bank_id, i, a, b });
+        }
+    };
+    addBank(managers.andGate->getDataBank(), 0);
+    addBank(managers.notGate->getDataBank(), 1);
+    addBank(managers.orGate->getDataBank(), 2);
+    addBank(managers.xorGate->getDataBank(), 3);
+
+    std::vector<uint32_t> transfer_from(transfers.size()), transfer_to(transfers.size());
+    for (size_t i = 0; i < transfers.size(); i++) {
+        transfer_from[i] = wordId(transfers[i].from);
+        transfer_to[i] = wordId(transfers[i].to);
+    }
+
+    // Bit level view of the transfers: the source bit driving each bit, and the transfers reading each bit
+    const size_t bit_count = output_gate.size() * STORAGE_SIZE;
+    auto forEachTransferBit = [&](auto f) {
+        for (uint32_t t = 0; t < transfers.size(); t++) {
+            for (size_t bit = 0; bit < STORAGE_SIZE; bit++) {
+                if (transfers[t].from_mask[bit]) {
+                    f(t, transfer_from[t] * STORAGE_SIZE + bit, transfer_to[t] * STORAGE_SIZE + bit + transfers[t].shift);
+                }
+            }
+        }
+    };
+    Groups drivers, readers;
+    drivers.build(bit_count, [&](auto add) { forEachTransferBit([&](uint32_t, size_t src, size_t dst) { add(dst, static_cast<uint32_t>(src)); }); });
+    readers.build(bit_count, [&](auto add) { forEachTransferBit([&](uint32_t t, size_t src, size_t) { add(src, t); }); });
+
+    // Depth of every bit: gate outputs are one deeper than their inputs, transfers keep the depth
+    std::vector<int32_t> depth(bit_count, UNVISITED);
+    auto gateInputs = [&](size_t bit, std::array<size_t, 2>& inputs) -> size_t {
+        const uint32_t gate = output_gate[bit / STORAGE_SIZE];
+        if (gate == NONE) {
+            return 0;
+        }
+        inputs = { gate_words[gate].a * STORAGE_SIZE + bit % STORAGE_SIZE, gate_words[gate].b * STORAGE_SIZE + bit % STORAGE_SIZE };
+        return 2;
+    };
+    std::vector<std::pair<size_t, size_t>> stack;
+    for (size_t root = 0; root < bit_count; root++) {
+        if (depth[root] != UNVISITED) {
+            continue;
+        }
+        stack.push_back({ root, 0 });
+        depth[root] = IN_PROGRESS;
+        while (!stack.empty()) {
+            auto& [bit, next_child] = stack.back();
+            std::array<size_t, 2> inputs;
+            const size_t gate_input_count = gateInputs(bit, inputs);
+            const size_t driver_count = drivers.offsets[bit + 1] - drivers.offsets[bit];
+            if (next_child < gate_input_count + driver_count) {
+                const size_t child = next_child < gate_input_count ? inputs[next_child] : drivers.values[drivers.offsets[bit] + next_child - gate_input_count];
+                next_child++;
+                if (depth[child] == IN_PROGRESS) {
+                    throw std::runtime_error("Combinational loop detected");
+                }
+                if (depth[child] == UNVISITED) {
+                    depth[child] = IN_PROGRESS;
+                    stack.push_back({ child, 0 });
+                }
+                continue;
+            }
+            int32_t result = 0;
+            for (size_t i = 0; i < gate_input_count; i++) {
+                result = std::max(result, depth[inputs[i]] + 1);
+            }
+            for (uint32_t i = drivers.offsets[bit]; i < drivers.offsets[bit + 1]; i++) {
+                result = std::max(result, depth[drivers.values[i]]);
+            }
+            depth[bit] = result;
+            stack.pop_back();
+        }
+    }
+
+    // Order the transfers so that a transfer runs after the transfers writing the bits it reads
+    std::vector<uint32_t> in_degree(transfers.size(), 0);
+    Groups successors;
+    auto forEachDependency = [&](auto f) {
+        forEachTransferBit([&](uint32_t t, size_t, size_t dst) {
+            for (uint32_t i = readers.offsets[dst]; i < readers.offsets[dst + 1]; i++) {
+                f(t, readers.values[i]);
+            }
+        });
+    };
+    successors.build(transfers.size(), [&](auto add) { forEachDependency(add); });
+    forEachDependency([&](uint32_t, uint32_t successor) { in_degree[successor]++; });
+    std::vector<uint32_t> order;
+    for (uint32_t t = 0; t < transfers.size(); t++) {
+        if (in_degree[t] == 0) {
+            order.push_back(t);
+        }
+    }
+    for (size_t i = 0; i < order.size(); i++) {
+        for (uint32_t j = successors.offsets[order[i]]; j < successors.offsets[order[i] + 1]; j++) {
+            if (--in_degree[successors.values[j]] == 0) {
+                order.push_back(successors.values[j]);
+            }
+        }
+    }
+    if (order.size() != transfers.size()) {
+        throw std::runtime_error("Combinational loop detected");
+    }
+
+    // A gate word is evaluated at every level one of its gates lives on,
+    // a transfer after every level one of its source bits settles on
+    auto stage = [&](size_t level) -> Stage& {
+        if (level >= stages.size()) {
+            stages.resize(level + 1);
+        }
+        return stages[level];
+    };
+    std::vector<int32_t> levels;
+    auto uniqueLevels = [&]() {
+        std::sort(levels.begin(), levels.end());
+        levels.erase(std::unique(levels.begin(), levels.end()), levels.end());
+    };
+    for (const auto& gate : gate_words) {
+        levels.clear();
+        for (size_t bit = 0; bit < STORAGE_SIZE; bit++) {
+            levels.push_back(std::max(depth[gate.a * STORAGE_SIZE + bit], depth[gate.b * STORAGE_SIZE + bit]) + 1);
+        }
+        uniqueLevels();
+        for (int32_t level : levels) {
+            stage(level).gate_words[gate.bank].push_back(gate.index);
+        }
+    }
+    for (uint32_t t : order) {
+        levels.clear();
+        for (size_t bit = 0; bit < STORAGE_SIZE; bit++) {
+            if (transfers[t].from_mask[bit]) {
+                levels.push_back(depth[transfer_from[t] * STORAGE_SIZE + bit]);
+            }
+        }
+        uniqueLevels();
+        for (int32_t level : levels) {
+            stage(level).transfers.push_back(t);
+        }
+    }
+    signature = computeSignature(managers);
+}
+
+size_t LevelizedScheduler::getDepth(Managers& managers)
+{
+    if (signature.empty() || signature != computeSignature(managers)) {
+        compile(managers);
+    }
+    return stages.empty() ? 0 : stages.size() - 1;
+}
+
+void LevelizedScheduler::tick(Managers& managers)
+{
+    if (signature.empty() || signature != computeSignature(managers)) {
+        compile(managers);
+    }
+    for (const Stage& stage : stages) {
+        for (uint32_t word : stage.gate_words[0]) {
+            managers.andGate->tickWord(word);
+        }
+        for (uint32_t word : stage.gate_words[1]) {
+            managers.notGate->tickWord(word);
+        }
+        for (uint32_t word : stage.gate_words[2]) {
+            managers.orGate->tickWord(word);
+        }
+        for (uint32_t word : stage.gate_words[3]) {
+            managers.xorGate->tickWord(word);
+        }
+        for (uint32_t transfer : stage.transfers) {
+            transfers[transfer].apply();
+        }
+    }
+}
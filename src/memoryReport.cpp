@@ -0,0 +1,46 @@
+#include "memoryReport.hpp"
+
+namespace {
+
+template <size_t N>
+MemoryReport::BankUsage bankUsage(std::string name, const DataBank<N>& bank)
+{
+    const auto usage = bank.getUsage();
+    return { std::move(name), usage.words, usage.bits_used, usage.bits_allocated };
+}
+
+}
+
+MemoryReport::MemoryReport(const Managers& managers)
+{
+    bank_words = managers.arena->wordBytes();
+    bank_metadata = managers.arena->metadataBytes() + managers.random_access_data_bank->metadataBytes()
+        + managers.andGate->getDataBank().metadataBytes() + managers.notGate->getDataBank().metadataBytes()
+        + managers.orGate->getDataBank().metadataBytes() + managers.xorGate->getDataBank().metadataBytes();
+    sockets = managers.socketController->memoryBytes();
+    banks.push_back(bankUsage("random_access", *managers.random_access_data_bank));
+    banks.push_back(bankUsage("and", managers.andGate->getDataBank()));
+    banks.push_back(bankUsage("not", managers.notGate->getDataBank()));
+    banks.push_back(bankUsage("or", managers.orGate->getDataBank()));
+    banks.push_back(bankUsage("xor", managers.xorGate->getDataBank()));
+}
+
+void MemoryReport::addCircuit(const Circuit& circuit)
+{
+    std::vector<const Circuit*> pending { &circuit };
+    while (!pending.empty()) {
+        const Circuit* current = pending.back();
+        pending.pop_back();
+        // Circuits are created by make_shared, the control block is part of the allocation
+        circuits += sizeof(Circuit) + 2 * sizeof(void*) + current->sub_circuits.capacity() * sizeof(std::shared_ptr<Circuit>);
+        for (const PortTable* table : { &current->bool_storage_access_map, &current->exposed_ports }) {
+            accessors += table->accessorBytes();
+            if (counted_layouts.insert(&table->getLayout()).second) {
+                names += table->getLayout().memoryBytes();
+            }
+        }
+        for (const auto& sub_circuit : current->sub_circuits) {
+            pending.push_back(sub_circuit.get());
+        }
+    }
+}
@@ -0,0 +1,123 @@
+#include "parallelScheduler.hpp"
+#include "managers.hpp"
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+
+void ParallelScheduler::setThreadCount(size_t threads)
+{
+    thread_count = std::max<size_t>(threads, 1);
+    pool.reset();
+    signature.clear();
+}
+
+std::vector<size_t> ParallelScheduler::computeSignature(Managers& managers) const
+{
+    return {
+        managers.andGate->getDataBank().size(),
+        managers.notGate->getDataBank().size(),
+        managers.orGate->getDataBank().size(),
+        managers.xorGate->getDataBank().size(),
+        managers.socketController->getSockets().size(),
+    };
+}
+
+void ParallelScheduler::compile(Managers& managers)
+{
+    thread_count = std::max<size_t>(thread_count, 1);
+    signature = computeSignature(managers);
+
+    gate_tasks.clear();
+    const size_t span_counts[] = {
+        managers.andGate->spanCount(),
+        managers.notGate->spanCount(),
+        managers.orGate->spanCount(),
+        managers.xorGate->spanCount(),
+    };
+    for (uint8_t bank = 0; bank < 4; bank++) {
+        for (size_t span = 0; span < span_counts[bank]; span++) {
+            gate_tasks.push_back({ bank, span });
+        }
+    }
+
+    // Transfers sharing a word end up in the same group (union-find over the words)
+    const auto& plan = managers.socketController->getPlan();
+    std::unordered_map<const BoolStorage*, size_t> word_ids;
+    std::vector<size_t> parent;
+    auto find = [&](size_t word) {
+        while (parent[word] != word) {
+            parent[word] = parent[parent[word]];
+            word = parent[word];
+        }
+        return word;
+    };
+    auto wordId = [&](const BoolStorage* word) {
+        auto [it, inserted] = word_ids.emplace(word, parent.size());
+        if (inserted) {
+            parent.push_back(parent.size());
+        }
+        return it->second;
+    };
+    for (const auto& transfer : plan) {
+        const size_t from = find(wordId(transfer.from));
+        const size_t to = find(wordId(transfer.to));
+        parent[from] = to;
+    }
+
+    // Distribute the groups over the threads, largest first onto the least loaded thread
+    std::vector<size_t> group_sizes(parent.size(), 0);
+    for (const auto& transfer : plan) {
+        group_sizes[find(word_ids[transfer.from])]++;
+    }
+    std::vector<size_t> groups(parent.size());
+    std::iota(groups.begin(), groups.end(), 0);
+    std::sort(groups.begin(), groups.end(), [&](size_t a, size_t b) { return group_sizes[a] > group_sizes[b]; });
+    std::vector<size_t> group_bucket(parent.size(), 0);
+    std::vector<size_t> bucket_sizes(thread_count, 0);
+    for (size_t group : groups) {
+        const size_t bucket = std::min_element(bucket_sizes.begin(), bucket_sizes.end()) - bucket_sizes.begin();
+        group_bucket[group] = bucket;
+        bucket_sizes[bucket] += group_sizes[group];
+    }
+
+    socket_groups.assign(thread_count, {});
+    for (const auto& transfer : plan) {
+        socket_groups[group_bucket[find(word_ids[transfer.from])]].push_back(transfer);
+    }
+    socket_groups.erase(std::remove_if(socket_groups.begin(), socket_groups.end(), [](const auto& group) { return group.empty(); }), socket_groups.end());
+
+    if (!pool || pool->threadCount() != thread_count) {
+        pool = std::make_unique<WorkerPool>(thread_count);
+    }
+}
+
+void ParallelScheduler::tick(Managers& managers)
+{
+    if (signature.empty() || signature != computeSignature(managers)) {
+        compile(managers);
+    }
+
+    pool->run(gate_tasks.size(), [&](size_t index) {
+        const GateTask& task = gate_tasks[index];
+        switch (task.bank) {
+        case 0:
+            managers.andGate->tickSpan(task.span);
+            break;
+        case 1:
+            managers.notGate->tickSpan(task.span);
+            break;
+        case 2:
+            managers.orGate->tickSpan(task.span);
+            break;
+        default:
+            managers.xorGate->tickSpan(task.span);
+            break;
+        }
+    });
+
+    pool->run(socket_groups.size(), [&](size_t index) {
+        for (const auto& transfer : socket_groups[index]) {
+            transfer.apply();
+        }
+    });
+}
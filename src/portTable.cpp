@@ -0,0 +1,175 @@
+#include "portTable.hpp"
+#include <stdexcept>
+
+PortLayout::PortLayout(const PortLayout& other)
+{
+    *this = other;
+}
+
+PortLayout& PortLayout::operator=(const PortLayout& other)
+{
+    if (this == &other) {
+        return *this;
+    }
+    names = other.names;
+    name_slots = other.name_slots;
+    slot_count = other.slot_count;
+    name_ids.clear();
+    for (uint32_t i = 0; i < names.size(); i++) {
+        name_ids.emplace(names[i], i);
+    }
+    return *this;
+}
+
+size_t PortLayout::memoryBytes() const
+{
+    // Hash nodes hold the key, the value, the cached hash and the next pointer
+    constexpr size_t NODE_BYTES = sizeof(std::pair<std::string_view, uint32_t>) + 2 * sizeof(void*);
+    size_t bytes = names.size() * sizeof(std::string) + name_slots.capacity() * sizeof(uint32_t);
+    for (const auto& name : names) {
+        // Short names are stored inside the string object
+        if (name.capacity() > std::string().capacity()) {
+            bytes += name.capacity() + 1;
+        }
+    }
+    return bytes + name_ids.bucket_count() * sizeof(void*) + name_ids.size() * NODE_BYTES;
+}
+
+uint32_t PortLayout::add(const std::string& name)
+{
+    const uint32_t existing = find(name);
+    if (existing != NONE) {
+        return existing;
+    }
+    names.push_back(name);
+    name_slots.push_back(slot_count);
+    name_ids.emplace(names.back(), static_cast<uint32_t>(names.size() - 1));
+    return slot_count++;
+}
+
+void PortLayout::alias(const std::string& name, uint32_t slot)
+{
+    auto it = name_ids.find(name);
+    if (it != name_ids.end()) {
+        name_slots[it->second] = slot;
+        return;
+    }
+    names.push_back(name);
+    name_slots.push_back(slot);
+    name_ids.emplace(names.back(), static_cast<uint32_t>(names.size() - 1));
+}
+
+uint32_t PortLayout::find(std::string_view name) const
+{
+    auto it = name_ids.find(name);
+    return it == name_ids.end() ? NONE : name_slots[it->second];
+}
+
+PortTable::PortTable()
+{
+    // Empty tables share one layout, it is copied as soon as a name is added
+    static const auto empty_layout = std::make_shared<const PortLayout>();
+    layout = empty_layout;
+}
+
+PortTable::PortTable(std::shared_ptr<const PortLayout> layout, const std::shared_ptr<StorageArena>& arena)
+    : layout(layout)
+    , arena(arena.get())
+    , arena_ref(arena)
+    , handles(layout->slotCount(), EMPTY)
+{
+}
+
+BoolStorageAccessor PortTable::materialize(StorageHandle handle) const
+{
+    // Checking for expiry reads the reference count without changing it, unlike locking
+    if (handle.word == StorageArena::NONE || arena_ref.expired()) {
+        return BoolStorageAccessor();
+    }
+    // The accessor shares ownership of the chunk holding the word, like the ones lent by data banks
+    return BoolStorageAccessor(handle.bit_offset, handle.size, std::shared_ptr<BoolStorage>(arena->getChunk(handle.word), &arena->word(handle.word)));
+}
+
+BoolStorageAccessor& PortTable::operator[](const std::string& name)
+{
+    uint32_t slot = find(name);
+    if (slot == PortLayout::NONE) {
+        // The layout may be shared with other circuits, so new names go into a private copy. The copy
+        // is only referenced by this table and its own_layout, unless the table itself was copied.
+        if (!own_layout || own_layout.use_count() != 2) {
+            own_layout = std::make_shared<PortLayout>(*layout);
+            layout = own_layout;
+        }
+        slot = own_layout->add(name);
+        handles.resize(layout->slotCount(), EMPTY);
+    }
+    auto [it, inserted] = accessors.try_emplace(slot);
+    if (inserted) {
+        it->second = materialize(handles[slot]);
+    }
+    return it->second;
+}
+
+BoolStorageAccessor PortTable::at(std::string_view name) const
+{
+    const uint32_t slot = find(name);
+    if (slot == PortLayout::NONE) {
+        throw std::runtime_error(std::string("Port ") + std::string(name) + " not found");
+    }
+    return this->slot(slot);
+}
+
+BoolStorageAccessor PortTable::slot(uint32_t slot) const
+{
+    // Built circuits usually hold no accessors at all, which saves hashing the slot
+    if (accessors.empty()) {
+        return materialize(handles[slot]);
+    }
+    auto it = accessors.find(slot);
+    return it != accessors.end() ? it->second : materialize(handles[slot]);
+}
+
+void PortTable::setSlot(uint32_t slot, const BoolStorageAccessor& accessor)
+{
+    auto it = accessors.find(slot);
+    if (it != accessors.end()) {
+        it->second = accessor;
+        return;
+    }
+    auto buffer = accessor.getBuffer();
+    const uint32_t word = buffer && !arena_ref.expired() ? arena->wordIndex(buffer.get()) : StorageArena::NONE;
+    if (word != StorageArena::NONE) {
+        handles[slot] = { word, static_cast<uint16_t>(accessor.getBitOffset()), static_cast<uint16_t>(accessor.getSocketSize()) };
+    } else if (buffer) {
+        accessors.emplace(slot, accessor);
+    } else {
+        handles[slot] = EMPTY;
+    }
+}
+
+void PortTable::setSlot(uint32_t slot, StorageHandle handle)
+{
+    auto it = accessors.empty() ? accessors.end() : accessors.find(slot);
+    if (it != accessors.end()) {
+        it->second = materialize(handle);
+        return;
+    }
+    handles[slot] = handle;
+}
+
+void PortTable::copySlot(uint32_t slot, const PortTable& source, uint32_t source_slot)
+{
+    const bool same_arena = arena == source.arena && !arena_ref.expired();
+    if (!same_arena || (!accessors.empty() && accessors.count(slot)) || (!source.accessors.empty() && source.accessors.count(source_slot))) {
+        setSlot(slot, source.slot(source_slot));
+        return;
+    }
+    handles[slot] = source.handles[source_slot];
+}
+
+size_t PortTable::accessorBytes() const
+{
+    // Hash nodes hold the slot, the accessor, the cached hash and the next pointer
+    constexpr size_t NODE_BYTES = sizeof(std::pair<const uint32_t, BoolStorageAccessor>) + 2 * sizeof(void*);
+    return handles.capacity() * sizeof(StorageHandle) + accessors.bucket_count() * sizeof(void*) + accessors.size() * NODE_BYTES;
+}
@@ -1,4 +1,6 @@
 #include "socketController.hpp"
+#include <algorithm>
+#include <unordered_set>
 
 void SocketController::addSocket(BoolStorageAccessor from, BoolStorageAccessor to)
 {
@@ -7,17 +9,108 @@ void SocketController::addSocket(BoolStorageAccessor from, BoolStorageAccessor t
     }
 
     sockets.emplace_back(Socket { from, to });
+    plan_compiled = false;
+}
+
+void SocketController::addSocket(const BusAccessor& from, const BusAccessor& to)
+{
+    if (from.getBitCount() != to.getBitCount()) {
+        throw std::runtime_error("Socket size mismatch");
+    }
+
+    size_t bit = 0;
+    while (bit < from.getBitCount()) {
+        const size_t from_room = STORAGE_SIZE - (from.getBitOffset() + bit) % STORAGE_SIZE;
+        const size_t to_room = STORAGE_SIZE - (to.getBitOffset() + bit) % STORAGE_SIZE;
+        const size_t piece = std::min({ from.getBitCount() - bit, from_room, to_room });
+        addSocket(from.slice(bit, piece), to.slice(bit, piece));
+        bit += piece;
+    }
+}
+
+void SocketController::compile()
+{
+    plan.clear();
+    plan_storage.clear();
+    std::unordered_set<BoolStorage*> pinned;
+
+    for (const auto& socket : sockets) {
+        const BoolStorageAccessor& from = socket.getFrom();
+        const BoolStorageAccessor& to = socket.getTo();
+        auto from_buffer = from.getBuffer();
+        auto to_buffer = to.getBuffer();
+        if (from.getSocketSize() == 0) {
+            continue;
+        }
+        for (const auto& buffer : { from_buffer, to_buffer }) {
+            if (pinned.insert(buffer.get()).second) {
+                plan_storage.push_back(buffer);
+            }
+        }
+
+        const auto mask = ONES >> (STORAGE_SIZE - from.getSocketSize());
+        Transfer transfer;
+        transfer.from = from_buffer.get();
+        transfer.to = to_buffer.get();
+        transfer.from_mask = mask << from.getBitOffset();
+        transfer.keep_mask = (mask << to.getBitOffset()).flip();
+        transfer.shift = static_cast<int>(to.getBitOffset()) - static_cast<int>(from.getBitOffset());
+        transfer.whole_word = false;
+
+        // Merge with the previous transfer if it moves bits between the same words by the same amount.
+        // Reading and writing different words means the order of the two transfers does not matter.
+        if (!plan.empty()) {
+            Transfer& previous = plan.back();
+            if (previous.from == transfer.from && previous.to == transfer.to && previous.shift == transfer.shift && transfer.from != transfer.to) {
+                previous.from_mask |= transfer.from_mask;
+                previous.keep_mask &= transfer.keep_mask;
+                previous.whole_word = previous.shift == 0 && previous.from_mask.all();
+                continue;
+            }
+        }
+        transfer.whole_word = transfer.shift == 0 && transfer.from_mask.all() && transfer.from != transfer.to;
+        plan.push_back(transfer);
+    }
+    plan_compiled = true;
+}
+
+const std::vector<SocketController::Transfer>& SocketController::getPlan()
+{
+    if (!plan_compiled) {
+        compile();
+    }
+    return plan;
 }
 
 void SocketController::tick()
 {
-    // clear the to buffer of each socket
-    for (auto& socket : sockets) {
-        // socket.preTick();
+    CIRCUITSIM_INSTRUMENT(PhaseTimer timer(stats);)
+    // copy the from buffer to the to buffer of each socket, in the order they were added
+    for (const auto& transfer : getPlan()) {
+        CIRCUITSIM_INSTRUMENT(WordChanges changes(stats, transfer.to, 1);)
+        transfer.apply();
     }
+}
 
-    // add the from buffer to the to buffer of each socket
-    for (auto& socket : sockets) {
-        socket.tick();
+SocketController::Locality SocketController::getLocality(const StorageArena& arena) const
+{
+    auto distance = [](uint32_t a, uint32_t b) { return static_cast<double>(a > b ? a - b : b - a); };
+    double distances = 0, strides = 0;
+    size_t counted = 0;
+    uint32_t previous_from = StorageArena::NONE, previous_to = StorageArena::NONE;
+    for (const auto& socket : sockets) {
+        const uint32_t from = arena.wordIndex(socket.getFrom().getBuffer().get());
+        const uint32_t to = arena.wordIndex(socket.getTo().getBuffer().get());
+        if (from == StorageArena::NONE || to == StorageArena::NONE) {
+            continue;
+        }
+        distances += distance(from, to);
+        if (counted > 0) {
+            strides += (distance(from, previous_from) + distance(to, previous_to)) / 2;
+        }
+        previous_from = from;
+        previous_to = to;
+        counted++;
     }
-}
\ No newline at end of file
+    return { counted > 0 ? distances / counted : 0, counted > 1 ? strides / (counted - 1) : 0 };
+}
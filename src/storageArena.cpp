@@ -0,0 +1,51 @@
+#include "storageArena.hpp"
+#include <memory>
+#include <new>
+#include <stdexcept>
+
+uint32_t StorageArena::allocateChunk()
+{
+    if (size() + CHUNK_SIZE > NONE) {
+        throw std::runtime_error("StorageArena is full");
+    }
+    const auto first_word = static_cast<uint32_t>(size());
+    // Chunks start on a cache line, so words of 128 bits and more never straddle a SIMD register boundary
+    auto* words = static_cast<BoolStorage*>(::operator new(sizeof(BoolStorage) * CHUNK_SIZE, std::align_val_t(CHUNK_ALIGNMENT)));
+    std::uninitialized_value_construct_n(words, CHUNK_SIZE);
+    chunks.emplace_back(words, [](BoolStorage* words) { ::operator delete(words, std::align_val_t(CHUNK_ALIGNMENT)); });
+    chunk_words.push_back(chunks.back().get());
+    chunk_ids.emplace(chunks.back().get(), static_cast<uint32_t>(chunks.size() - 1));
+    return first_word;
+}
+
+size_t StorageArena::metadataBytes() const
+{
+    // A control block with a custom deleter, and a red-black tree node per chunk
+    constexpr size_t CONTROL_BLOCK_BYTES = 32;
+    constexpr size_t MAP_NODE_BYTES = 32 + sizeof(std::pair<const BoolStorage*, uint32_t>);
+    return chunks.capacity() * sizeof(chunks[0]) + chunk_words.capacity() * sizeof(BoolStorage*)
+        + chunks.size() * (CONTROL_BLOCK_BYTES + MAP_NODE_BYTES);
+}
+
+uint32_t StorageArena::wordIndex(const BoolStorage* word) const
+{
+    auto it = chunk_ids.upper_bound(word);
+    if (it == chunk_ids.begin()) {
+        return NONE;
+    }
+    --it;
+    const auto offset = (reinterpret_cast<uintptr_t>(word) - reinterpret_cast<uintptr_t>(it->first)) / sizeof(BoolStorage);
+    if (offset >= CHUNK_SIZE) {
+        return NONE;
+    }
+    return static_cast<uint32_t>(it->second * CHUNK_SIZE + offset);
+}
+
+StorageHandle StorageArena::handle(const BoolStorageAccessor& accessor) const
+{
+    const uint32_t index = wordIndex(accessor.getBuffer().get());
+    if (index == NONE) {
+        throw std::runtime_error("Accessor does not point into the arena");
+    }
+    return { index, static_cast<uint16_t>(accessor.getBitOffset()), static_cast<uint16_t>(accessor.getSocketSize()) };
+}
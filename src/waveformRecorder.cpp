@@ -0,0 +1,227 @@
+#include "waveformRecorder.hpp"
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+/// @brief VCD identifier codes are strings of the printable characters '!' to '~'
+std::string identifierCode(size_t index)
+{
+    std::string code;
+    do {
+        code += static_cast<char>('!' + index % 94);
+        index /= 94;
+    } while (index > 0);
+    return code;
+}
+
+}
+
+WaveformRecorder::WaveformRecorder(std::ostream& out, std::string timescale)
+    : out(out)
+    , timescale(std::move(timescale))
+{
+    batch.reserve(BATCH_SIZE);
+}
+
+WaveformRecorder::~WaveformRecorder()
+{
+    close();
+}
+
+void WaveformRecorder::addPort(const std::string& scope, const std::string& name, const BoolStorageAccessor& port)
+{
+    if (started) {
+        throw std::runtime_error("Ports can not be added after sampling started");
+    }
+    if (port.getSocketSize() == 0) {
+        return;
+    }
+
+    uint32_t scope_id = 0;
+    while (scope_id < scopes.size() && scopes[scope_id] != scope) {
+        scope_id++;
+    }
+    if (scope_id == scopes.size()) {
+        scopes.push_back(scope);
+        scope_names.emplace_back();
+    }
+
+    auto buffer = port.getBuffer();
+    auto [word, new_word] = word_ids.emplace(buffer.get(), static_cast<uint32_t>(words.size()));
+    if (new_word) {
+        words.push_back(buffer.get());
+        previous.push_back(*buffer);
+        word_signals.emplace_back();
+        storage.push_back(buffer);
+    }
+
+    const uint64_t key = uint64_t(word->second) << 32 | port.getBitOffset() << 16 | port.getSocketSize();
+    auto [signal, new_signal] = signal_ids.emplace(key, static_cast<uint32_t>(signals.size()));
+    if (new_signal) {
+        const BoolStorage mask = (ONES >> (STORAGE_SIZE - port.getSocketSize())) << port.getBitOffset();
+        signals.push_back({ word->second, static_cast<uint16_t>(port.getBitOffset()), static_cast<uint16_t>(port.getSocketSize()), mask, identifierCode(signals.size()) });
+        word_signals[word->second].push_back(signal->second);
+    }
+    scope_names[scope_id].push_back({ name, signal->second });
+}
+
+void WaveformRecorder::addCircuit(const std::string& scope, const Circuit& circuit)
+{
+    for (const auto [name, port] : circuit.bool_storage_access_map) {
+        addPort(scope, name, port);
+    }
+}
+
+void WaveformRecorder::sample(uint64_t time)
+{
+    if (closed) {
+        throw std::runtime_error("WaveformRecorder is closed");
+    }
+    if (!started) {
+        writeHeader();
+        started = true;
+        writer = std::thread(&WaveformRecorder::writerLoop, this);
+        batch.push_back({ TIME, time, {} });
+        for (uint32_t i = 0; i < signals.size(); i++) {
+            const Signal& signal = signals[i];
+            batch.push_back({ i, 0, (*words[signal.word] & signal.mask) >> signal.bit_offset });
+        }
+        change_count += signals.size();
+        last_time = time;
+        submit();
+        return;
+    }
+    if (time <= last_time) {
+        throw std::runtime_error("Sample times must increase");
+    }
+    last_time = time;
+
+    bool stamped = false;
+    for (size_t i = 0; i < words.size(); i++) {
+        const BoolStorage current = *words[i];
+        const BoolStorage changed = current ^ previous[i];
+        if (changed.none()) {
+            continue;
+        }
+        previous[i] = current;
+        for (uint32_t index : word_signals[i]) {
+            const Signal& signal = signals[index];
+            if ((changed & signal.mask).none()) {
+                continue;
+            }
+            if (!stamped) {
+                batch.push_back({ TIME, time, {} });
+                stamped = true;
+            }
+            batch.push_back({ index, 0, (current & signal.mask) >> signal.bit_offset });
+            change_count++;
+        }
+    }
+    if (batch.size() >= BATCH_SIZE) {
+        submit();
+    }
+}
+
+void WaveformRecorder::close()
+{
+    if (closed) {
+        return;
+    }
+    closed = true;
+    if (!started) {
+        writeHeader();
+    } else {
+        submit();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        queued_condition.notify_one();
+        writer.join();
+    }
+    out.flush();
+}
+
+void WaveformRecorder::submit()
+{
+    if (batch.empty()) {
+        return;
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        // Bound the memory held by the queue when the writer can not keep up
+        drained_condition.wait(lock, [this] { return queue.size() < MAX_QUEUED_BATCHES; });
+        queue.push_back(std::move(batch));
+    }
+    queued_condition.notify_one();
+    batch = {};
+    batch.reserve(BATCH_SIZE);
+}
+
+void WaveformRecorder::writerLoop()
+{
+    std::vector<std::vector<Change>> work;
+    std::string text;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            queued_condition.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) {
+                return;
+            }
+            work.swap(queue);
+        }
+        drained_condition.notify_one();
+        for (const auto& changes : work) {
+            text.clear();
+            writeChanges(changes, text);
+            out.write(text.data(), static_cast<std::streamsize>(text.size()));
+        }
+        work.clear();
+    }
+}
+
+void WaveformRecorder::writeHeader()
+{
+    out << "$version circuitsim $end\n";
+    out << "$timescale " << timescale << " $end\n";
+    for (size_t i = 0; i < scopes.size(); i++) {
+        out << "$scope module " << scopes[i] << " $end\n";
+        for (const auto& name : scope_names[i]) {
+            const Signal& signal = signals[name.signal];
+            out << "$var wire " << signal.size << " " << signal.id << " " << name.name << " $end\n";
+        }
+        out << "$upscope $end\n";
+    }
+    out << "$enddefinitions $end\n";
+}
+
+void WaveformRecorder::writeChanges(const std::vector<Change>& changes, std::string& text) const
+{
+    for (const auto& change : changes) {
+        if (change.signal == TIME) {
+            text += '#';
+            text += std::to_string(change.time);
+            text += '\n';
+            continue;
+        }
+        const Signal& signal = signals[change.signal];
+        if (signal.size == 1) {
+            text += change.value[0] ? '1' : '0';
+        } else {
+            // Vectors are written most significant bit first, without leading zeros
+            size_t bit = signal.size;
+            while (bit > 1 && !change.value[bit - 1]) {
+                bit--;
+            }
+            text += 'b';
+            while (bit > 0) {
+                text += change.value[--bit] ? '1' : '0';
+            }
+            text += ' ';
+        }
+        text += signal.id;
+        text += '\n';
+    }
+}
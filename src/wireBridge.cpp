@@ -1,21 +1,40 @@
 #include "wireBridge.hpp"
+#include <algorithm>
+
+size_t wireBridgeWidth(const WireBridgeData& ports)
+{
+    // Every view starts at the first bit of the bridge, so the bridge is as wide as its widest view
+    size_t width = 0;
+    for (const auto& port : ports) {
+        size_t port_width = 0;
+        for (const auto& size : port) {
+            port_width += size;
+        }
+        if (port_width > STORAGE_SIZE) {
+            throw std::runtime_error("Port size exceeds STORAGE_SIZE");
+        }
+        width = std::max(width, port_width);
+    }
+    return width;
+}
 
 std::vector<std::vector<BoolStorageAccessor>> wireBridge(DataBank<1>& db, const WireBridgeData& ports)
 {
-    auto [storage] = db.lendStorage();
+    const size_t width = wireBridgeWidth(ports);
+
+    // Bridges share words with other bridges, only the bits they need are lent
+    auto [bridge] = db.lendBools(width);
+    auto storage = bridge.getBuffer();
     std::vector<std::vector<BoolStorageAccessor>> result;
     result.reserve(ports.size());
     for (const auto& port : ports) {
         std::vector<BoolStorageAccessor> accessors;
         accessors.reserve(port.size());
-        size_t offset = 0;
+        size_t offset = bridge.getBitOffset();
         for (const auto& size : port) {
             accessors.emplace_back(BoolStorageAccessor(offset, size, storage));
             offset += size;
         }
-        if (offset > STORAGE_SIZE) {
-            throw std::runtime_error("Port size exceeds STORAGE_SIZE");
-        }
         result.emplace_back(accessors);
     }
     return result;
@@ -0,0 +1,71 @@
+#include "workerPool.hpp"
+
+WorkerPool::WorkerPool(size_t thread_count)
+{
+    for (size_t i = 1; i < thread_count; i++) {
+        workers.emplace_back(&WorkerPool::workerLoop, this);
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    start_condition.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void WorkerPool::runTasks()
+{
+    for (size_t index = next_task.fetch_add(1); index < task_count; index = next_task.fetch_add(1)) {
+        invoke(context, index);
+    }
+}
+
+void WorkerPool::workerLoop()
+{
+    size_t seen_generation = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            start_condition.wait(lock, [&] { return stopping || generation != seen_generation; });
+            if (stopping) {
+                return;
+            }
+            seen_generation = generation;
+        }
+        runTasks();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            busy_workers--;
+        }
+        done_condition.notify_one();
+    }
+}
+
+void WorkerPool::runBatch(void (*batch_invoke)(void*, size_t), void* batch_context, size_t batch_task_count)
+{
+    if (workers.empty() || batch_task_count <= 1) {
+        for (size_t i = 0; i < batch_task_count; i++) {
+            batch_invoke(batch_context, i);
+        }
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        invoke = batch_invoke;
+        context = batch_context;
+        task_count = batch_task_count;
+        next_task = 0;
+        busy_workers = workers.size();
+        generation++;
+    }
+    start_condition.notify_all();
+    runTasks();
+    std::unique_lock<std::mutex> lock(mutex);
+    done_condition.wait(lock, [&] { return busy_workers == 0; });
+}
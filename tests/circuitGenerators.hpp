@@ -0,0 +1,137 @@
+#include "circuit.hpp"
+#include "circuitSchematic.hpp"
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#pragma once
+
+/// @brief A full adder with exposed ports input_0, input_1, carryIn_0, sum_0 and carry_0
+inline std::shared_ptr<CircuitSchematic> fullAdderSchematic()
+{
+    auto cs = CircuitSchematic::create("full_adder");
+    cs->addXorGate("xor1");
+    cs->addXorGate("xor2");
+    cs->addAndGate("and1");
+    cs->addAndGate("and2");
+    cs->addOrGate("or1");
+    cs->addWireBridge({ { "input", { 1, 1 } } });
+    cs->addWireBridge({ { "carryIn", { 1 } } });
+    cs->addWireBridge({ { "sum", { 1 } } });
+    cs->addWireBridge({ { "carry", { 1 } } });
+    cs->addExposedPort("input_0");
+    cs->addExposedPort("input_1");
+    cs->addExposedPort("carryIn_0");
+    cs->addExposedPort("sum_0");
+    cs->addExposedPort("carry_0");
+    cs->addConnection("input_0", "xor1_a");
+    cs->addConnection("input_1", "xor1_b");
+    cs->addConnection("xor1_c", "xor2_a");
+    cs->addConnection("carryIn_0", "xor2_b");
+    cs->addConnection("xor2_c", "sum_0");
+    cs->addConnection("input_0", "and1_a");
+    cs->addConnection("input_1", "and1_b");
+    cs->addConnection("xor1_c", "and2_a");
+    cs->addConnection("carryIn_0", "and2_b");
+    cs->addConnection("and1_c", "or1_a");
+    cs->addConnection("and2_c", "or1_b");
+    cs->addConnection("or1_c", "carry_0");
+    return cs;
+}
+
+/// @brief A ripple carry adder with exposed ports a_<i>, b_<i>, sum_<i> and carry_0.
+/// The full adder schematic has to outlive the returned schematic.
+inline std::shared_ptr<CircuitSchematic> rippleAdderSchematic(std::shared_ptr<CircuitSchematic> full_adder, size_t bits)
+{
+    auto cs = CircuitSchematic::create("ripple_adder_" + std::to_string(bits));
+    cs->addWireBridge({ { "a", std::vector<size_t>(bits, 1) } });
+    cs->addWireBridge({ { "b", std::vector<size_t>(bits, 1) } });
+    cs->addWireBridge({ { "sum", std::vector<size_t>(bits, 1) } });
+    cs->addWireBridge({ { "carry", { 1 } } });
+    for (size_t i = 0; i < bits; i++) {
+        const std::string fa = "fa" + std::to_string(i);
+        cs->addSubCircuit(fa, full_adder);
+        cs->addConnection("a_" + std::to_string(i), fa + "_input_0");
+        cs->addConnection("b_" + std::to_string(i), fa + "_input_1");
+        cs->addConnection(fa + "_sum_0", "sum_" + std::to_string(i));
+        if (i > 0) {
+            cs->addConnection("fa" + std::to_string(i - 1) + "_carry_0", fa + "_carryIn_0");
+        }
+        cs->addExposedPort("a_" + std::to_string(i));
+        cs->addExposedPort("b_" + std::to_string(i));
+        cs->addExposedPort("sum_" + std::to_string(i));
+    }
+    cs->addConnection("fa" + std::to_string(bits - 1) + "_carry_0", "carry_0");
+    cs->addExposedPort("carry_0");
+    return cs;
+}
+
+/// @brief A random netlist of gates with exposed ports in_<i> and out_<i>.
+/// Without feedback every gate input is driven by an input port or an earlier gate.
+inline std::shared_ptr<CircuitSchematic> randomSchematic(uint64_t seed, size_t inputs, size_t gates, size_t outputs, bool feedback)
+{
+    std::mt19937_64 rng(seed);
+    auto cs = CircuitSchematic::create("random_" + std::to_string(seed));
+    cs->addWireBridge({ { "in", std::vector<size_t>(inputs, 1) } });
+    cs->addWireBridge({ { "out", std::vector<size_t>(outputs, 1) } });
+    std::vector<std::string> drivers;
+    for (size_t i = 0; i < inputs; i++) {
+        drivers.push_back("in_" + std::to_string(i));
+        cs->addExposedPort("in_" + std::to_string(i));
+    }
+    std::vector<std::string> gate_outputs;
+    std::vector<std::string> gate_inputs;
+    for (size_t i = 0; i < gates; i++) {
+        const std::string name = "g" + std::to_string(i);
+        switch (rng() % 4) {
+        case 0:
+            cs->addAndGate(name);
+            break;
+        case 1:
+            cs->addOrGate(name);
+            break;
+        case 2:
+            cs->addXorGate(name);
+            break;
+        default:
+            cs->addNotGate(name);
+            gate_inputs.push_back(name + "_a");
+            gate_outputs.push_back(name + "_b");
+            continue;
+        }
+        gate_inputs.push_back(name + "_a");
+        gate_inputs.push_back(name + "_b");
+        gate_outputs.push_back(name + "_c");
+    }
+    // Connect the gates in declaration order, so that without feedback the netlist stays acyclic
+    size_t next_output = 0;
+    for (const auto& input : gate_inputs) {
+        const std::string gate = input.substr(0, input.rfind('_'));
+        while (next_output < gate_outputs.size() && gate_outputs[next_output].rfind(gate + "_", 0) != 0) {
+            drivers.push_back(gate_outputs[next_output++]);
+        }
+        const auto& pool = feedback ? gate_outputs : drivers;
+        const bool from_gate = feedback && rng() % 3 != 0;
+        cs->addConnection(from_gate ? pool[rng() % pool.size()] : drivers[rng() % drivers.size()], input);
+    }
+    for (size_t i = 0; i < outputs; i++) {
+        cs->addConnection(gate_outputs[rng() % gate_outputs.size()], "out_" + std::to_string(i));
+        cs->addExposedPort("out_" + std::to_string(i));
+    }
+    return cs;
+}
+
+/// @brief Read the value of every port of a circuit and all of its sub-circuits
+inline std::vector<unsigned long long> circuitState(const Circuit& circuit)
+{
+    std::vector<unsigned long long> state;
+    for (const auto& [name, accessor] : circuit.bool_storage_access_map) {
+        state.push_back(accessor.get().to_ullong());
+    }
+    for (const auto& sub_circuit : circuit.sub_circuits) {
+        auto sub_state = circuitState(*sub_circuit);
+        state.insert(state.end(), sub_state.begin(), sub_state.end());
+    }
+    return state;
+}
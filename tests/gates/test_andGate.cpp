@@ -50,4 +50,19 @@ TEST_CASE("AndGate with multiple storages", "[AndGate][Gate]")
     e.set(0b1);
     gate.tick();
     REQUIRE(f.get() == 0b1);
-}
\ No newline at end of file
+}
+TEST_CASE("AndGate across many storage words", "[AndGate][Gate]")
+{
+    AndGate gate;
+    std::vector<std::array<BoolStorageAccessor, 3>> gates;
+    for (size_t i = 0; i < STORAGE_SIZE * 5 + 7; i++) {
+        gates.emplace_back(gate.lendGate());
+        auto& [a, b, c] = gates.back();
+        a.set(i % 2);
+        b.set(i % 3 == 0);
+    }
+    gate.tick();
+    for (size_t i = 0; i < gates.size(); i++) {
+        REQUIRE(gates[i][2].get() == ((i % 2) && (i % 3 == 0)));
+    }
+}
@@ -0,0 +1,44 @@
+#include "gates/gateKernels.hpp"
+#include <catch2/catch_amalgamated.hpp>
+#include <random>
+#include <vector>
+
+TEST_CASE("Gate kernels match the scalar reference on every supported instruction set", "[GateKernels][Gate]")
+{
+    const KernelIsa previous = getKernelIsa();
+    KernelIsa isa = GENERATE(KernelIsa::Scalar, KernelIsa::Avx2, KernelIsa::Avx512);
+    if (isa > detectKernelIsa()) {
+        REQUIRE_THROWS(setKernelIsa(isa));
+        return;
+    }
+    setKernelIsa(isa);
+    REQUIRE(getKernelIsa() == isa);
+
+    std::mt19937_64 rng(42);
+    // Odd sizes make sure the scalar tail of the vector kernels is exercised
+    size_t size = GENERATE(0, 1, 3, 8, 13, 67);
+    std::vector<BoolStorage> a(size), b(size), c(size);
+    for (size_t i = 0; i < size; i++) {
+        a[i] = rng();
+        b[i] = rng();
+    }
+
+    andKernel(a.data(), b.data(), c.data(), size);
+    for (size_t i = 0; i < size; i++) {
+        REQUIRE(c[i] == (a[i] & b[i]));
+    }
+    orKernel(a.data(), b.data(), c.data(), size);
+    for (size_t i = 0; i < size; i++) {
+        REQUIRE(c[i] == (a[i] | b[i]));
+    }
+    xorKernel(a.data(), b.data(), c.data(), size);
+    for (size_t i = 0; i < size; i++) {
+        REQUIRE(c[i] == (a[i] ^ b[i]));
+    }
+    notKernel(a.data(), c.data(), size);
+    for (size_t i = 0; i < size; i++) {
+        REQUIRE(c[i] == ~a[i]);
+    }
+
+    setKernelIsa(previous);
+}
@@ -0,0 +1,85 @@
+#include "batchSimulator.hpp"
+#include "circuitGenerators.hpp"
+#include <catch2/catch_amalgamated.hpp>
+
+TEST_CASE("BatchSimulator runs an exhaustive full adder test in one pass", "[batchSimulator]")
+{
+    auto cs = fullAdderSchematic();
+    Managers m;
+    auto circuit = cs->build(m);
+    BatchSimulator<> batch(m);
+    REQUIRE(batch.gateCount() == 5);
+
+    // Lane i holds input combination i
+    for (size_t lane = 0; lane < 8; lane++) {
+        batch.set(circuit->exposed_ports["input_0"], lane, lane & 1);
+        batch.set(circuit->exposed_ports["input_1"], lane, (lane >> 1) & 1);
+        batch.set(circuit->exposed_ports["carryIn_0"], lane, (lane >> 2) & 1);
+    }
+    for (size_t t = 0; t < 10; t++) {
+        batch.tick();
+    }
+    for (size_t lane = 0; lane < 8; lane++) {
+        const size_t total = (lane & 1) + ((lane >> 1) & 1) + ((lane >> 2) & 1);
+        REQUIRE(batch.get(circuit->exposed_ports["sum_0"], lane) == (total & 1));
+        REQUIRE(batch.get(circuit->exposed_ports["carry_0"], lane) == (total >> 1));
+    }
+}
+
+TEMPLATE_TEST_CASE_SIG("BatchSimulator lanes match independent simulations", "[batchSimulator]", ((size_t LANES), LANES), 64, 256)
+{
+    const bool feedback = GENERATE(false, true);
+    auto cs = randomSchematic(11, 8, 150, 8, feedback);
+    Managers base;
+    auto base_circuit = cs->build(base);
+    BatchSimulator<LANES> batch(base);
+
+    std::mt19937_64 rng(5);
+    std::vector<std::vector<int>> stimuli(LANES, std::vector<int>(8));
+    for (size_t lane = 0; lane < LANES; lane++) {
+        for (size_t i = 0; i < 8; i++) {
+            stimuli[lane][i] = rng() % 2;
+            batch.set(base_circuit->exposed_ports["in_" + std::to_string(i)], lane, stimuli[lane][i]);
+        }
+    }
+    for (size_t t = 0; t < 25; t++) {
+        batch.tick();
+    }
+
+    // Check a sample of the lanes against scalar simulations
+    for (size_t lane = 0; lane < LANES; lane += 37) {
+        Managers m;
+        auto circuit = cs->build(m);
+        for (size_t i = 0; i < 8; i++) {
+            circuit->exposed_ports["in_" + std::to_string(i)].set(stimuli[lane][i]);
+        }
+        for (size_t t = 0; t < 25; t++) {
+            m.tick();
+        }
+        for (size_t i = 0; i < 8; i++) {
+            const std::string port = "out_" + std::to_string(i);
+            REQUIRE(batch.get(base_circuit->exposed_ports[port], lane) == circuit->exposed_ports[port].get());
+            REQUIRE(batch.getLanes(base_circuit->exposed_ports[port], 0)[lane] == circuit->exposed_ports[port].get()[0]);
+        }
+    }
+}
+
+TEST_CASE("BatchSimulator copies overlapping ranges of one word like Managers::tick", "[batchSimulator]")
+{
+    auto cs = CircuitSchematic::create("overlap");
+    cs->addWireBridge({ { "word", { 8 } } });
+    // Each direction moves bits within the same word across bits it also reads
+    const size_t from_offset = GENERATE(0, 2), to_offset = 2 - from_offset;
+    Managers m;
+    auto circuit = cs->build(m);
+    auto buffer = circuit->bool_storage_access_map["word_0"].getBuffer();
+    BoolStorageAccessor from(from_offset, 4, buffer), to(to_offset, 4, buffer);
+    m.socketController->addSocket(from, to);
+    from.set(0b1011);
+
+    BatchSimulator<> batch(m);
+    m.tick();
+    batch.tick();
+    REQUIRE(batch.get(circuit->bool_storage_access_map["word_0"], 0) == circuit->bool_storage_access_map["word_0"].get());
+    REQUIRE(batch.get(to, 0) == 0b1011);
+}
@@ -0,0 +1,196 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include "blifReader.hpp"
+#include <sstream>
+
+namespace {
+
+std::shared_ptr<CircuitSchematic> readBlif(BlifReader& reader, const std::string& text)
+{
+    std::istringstream in(text);
+    reader.read(in);
+    return reader.getTop();
+}
+
+/// @brief Set the inputs of a circuit, tick until it settles and get an output
+bool evaluate(Managers& managers, Circuit& circuit, const std::vector<std::pair<std::string, bool>>& inputs, const std::string& output)
+{
+    for (const auto& [name, value] : inputs) {
+        circuit.exposed_ports[name].set(value);
+    }
+    for (int tick = 0; tick < 24; tick++) {
+        managers.tick();
+    }
+    return circuit.exposed_ports.at(output).get()[0];
+}
+
+const char* FULL_ADDER = R"(
+# A full adder with a three input XOR cover
+.model fa
+.inputs a b cin
+.outputs s cout
+.names a b cin s
+100 1
+010 1
+001 1
+111 1
+.names a b t1
+11 1
+.names a b \
+  t2
+1- 1
+-1 1
+.names t2 cin t3
+11 1
+.names t1 t3 cout
+1- 1
+-1 1
+.end
+)";
+
+}
+
+TEST_CASE("BlifReader reads a full adder", "[blifReader]")
+{
+    BlifReader reader;
+    auto schematic = readBlif(reader, FULL_ADDER);
+    REQUIRE(reader.getBytesRead() == std::string(FULL_ADDER).size());
+    Managers managers;
+    auto circuit = schematic->build(managers);
+    for (int value = 0; value < 8; value++) {
+        const bool a = value & 1, b = value & 2, cin = value & 4;
+        const std::vector<std::pair<std::string, bool>> inputs { { "a", a }, { "b", b }, { "cin", cin } };
+        REQUIRE(evaluate(managers, *circuit, inputs, "s") == (a ^ b ^ cin));
+        REQUIRE(evaluate(managers, *circuit, inputs, "cout") == ((a + b + cin) >= 2));
+    }
+}
+
+TEST_CASE("BlifReader maps every two input function", "[blifReader]")
+{
+    std::string text = ".model functions\n.inputs a b\n.outputs";
+    for (int function = 0; function < 16; function++) {
+        text += " y" + std::to_string(function);
+    }
+    text += "\n";
+    for (int function = 0; function < 16; function++) {
+        text += ".names a b y" + std::to_string(function) + "\n";
+        for (int minterm = 0; minterm < 4; minterm++) {
+            if ((function >> minterm) & 1) {
+                text += std::to_string(minterm & 1) + std::to_string((minterm >> 1) & 1) + " 1\n";
+            }
+        }
+    }
+    // The same functions described by their off-set
+    text += ".outputs nand\n.names a b nand\n11 0\n";
+
+    BlifReader reader;
+    auto schematic = readBlif(reader, text);
+    Managers managers;
+    auto circuit = schematic->build(managers);
+    for (int minterm = 0; minterm < 4; minterm++) {
+        const std::vector<std::pair<std::string, bool>> inputs { { "a", minterm & 1 }, { "b", (minterm >> 1) & 1 } };
+        for (int function = 0; function < 16; function++) {
+            INFO("function " << function << ", minterm " << minterm);
+            REQUIRE(evaluate(managers, *circuit, inputs, "y" + std::to_string(function)) == bool((function >> minterm) & 1));
+        }
+        REQUIRE(evaluate(managers, *circuit, inputs, "nand") == (minterm != 3));
+    }
+}
+
+TEST_CASE("BlifReader instantiates models defined later", "[blifReader]")
+{
+    const std::string text = R"(
+.model adder2
+.inputs a0 a1 b0 b1
+.outputs s0 s1 c
+.subckt fa a=a0 b=b0 cin=zero s=s0 cout=c0
+.subckt fa a=a1 b=b1 cin=c0 s=s1 cout=c
+.names zero
+.end
+)" + std::string(FULL_ADDER);
+
+    BlifReader reader;
+    auto schematic = readBlif(reader, text);
+    REQUIRE(reader.getModel("fa") != nullptr);
+    Managers managers;
+    auto circuit = schematic->build(managers);
+    for (int a = 0; a < 4; a++) {
+        for (int b = 0; b < 4; b++) {
+            const std::vector<std::pair<std::string, bool>> inputs { { "a0", a & 1 }, { "a1", a & 2 }, { "b0", b & 1 }, { "b1", b & 2 } };
+            const int sum = evaluate(managers, *circuit, inputs, "s0") | evaluate(managers, *circuit, inputs, "s1") << 1 | evaluate(managers, *circuit, inputs, "c") << 2;
+            REQUIRE(sum == a + b);
+        }
+    }
+}
+
+TEST_CASE("BlifReader reports invalid netlists", "[blifReader]")
+{
+    BlifReader reader;
+    auto read = [&](const std::string& text) {
+        std::istringstream in(text);
+        BlifReader fresh;
+        fresh.read(in);
+    };
+    REQUIRE_THROWS(reader.getTop());
+    REQUIRE_THROWS(read(".model m\n.outputs y\n.names a y\n1 1\n.end\n"));
+    REQUIRE_THROWS(read(".model m\n.inputs a\n.names a a\n1 1\n.end\n"));
+    REQUIRE_THROWS(read(".model m\n.inputs a b c\n.names a b c y\n11- 1\n1-1 1\n-11 1\n.end\n"));
+    REQUIRE_THROWS(read(".model m\n.inputs a\n.names a y\n1 1\n2 1\n.end\n"));
+    REQUIRE_THROWS(read(".model m\n.inputs a\n.names a y\n1 1\n0 0\n.end\n"));
+    REQUIRE_THROWS(read(".model m\n.inputs a\n.subckt missing x=a\n.end\n"));
+    REQUIRE_THROWS(read(".model m\n.inputs a\n.latch a q 0\n.end\n"));
+    REQUIRE_THROWS_WITH(read(".model m\n.inputs a\n\n11 1\n"), "BLIF line 4: Unexpected line outside of a .names block");
+}
+
+TEST_CASE("BlifReader keeps net names apart from generated ports", "[blifReader]")
+{
+    // Net names that look like the ports of gates and bridges named after other nets
+    const std::string text = R"(
+.model names
+.inputs x_a q y_0 y_c
+.outputs x y
+.names x_a q x
+11 1
+.names y_0 y_c y
+01 1
+10 1
+.end
+)";
+    BlifReader reader;
+    auto schematic = readBlif(reader, text);
+    Managers managers;
+    auto circuit = schematic->build(managers);
+    for (int value = 0; value < 4; value++) {
+        const bool a = value & 1, b = value & 2;
+        const std::vector<std::pair<std::string, bool>> inputs { { "x_a", a }, { "q", b }, { "y_0", a }, { "y_c", b } };
+        REQUIRE(evaluate(managers, *circuit, inputs, "x") == (a && b));
+        REQUIRE(evaluate(managers, *circuit, inputs, "y") == (a != b));
+    }
+
+    // A net named like a model, the gate driving it and the sub-circuit get names of their own
+    const std::string shadowed = R"(
+.model top
+.inputs x y
+.outputs inv p
+.names x y inv
+11 1
+.subckt inv a=x b=p
+.end
+.model inv
+.inputs a
+.outputs b
+.names a b
+0 1
+.end
+)";
+    BlifReader shadowed_reader;
+    auto shadowed_schematic = readBlif(shadowed_reader, shadowed);
+    Managers shadowed_managers;
+    auto shadowed_circuit = shadowed_schematic->build(shadowed_managers);
+    for (int value = 0; value < 4; value++) {
+        const bool x = value & 1, y = value & 2;
+        const std::vector<std::pair<std::string, bool>> inputs { { "x", x }, { "y", y } };
+        REQUIRE(evaluate(shadowed_managers, *shadowed_circuit, inputs, "inv") == (x && y));
+        REQUIRE(evaluate(shadowed_managers, *shadowed_circuit, inputs, "p") == !x);
+    }
+}
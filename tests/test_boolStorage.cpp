@@ -34,8 +34,8 @@ TEST_CASE("BoolStorageAccessor can set at the correct place", "[boolStorageAcces
         auto bs = std::make_shared<BoolStorage>(0);
         BoolStorageAccessor bsa(i, 6, bs);
         bsa.set(0b101010);
-        REQUIRE(bs->to_ullong() >> i == 0b101010);
-        REQUIRE(bs->to_ullong() == 0b101010ULL << i);
+        REQUIRE((*bs >> i) == BoolStorage(0b101010));
+        REQUIRE(*bs == BoolStorage(0b101010) << i);
     }
 }
 
@@ -79,8 +79,8 @@ TEST_CASE("BoolStorageAccessor clears correct bits", "[boolStorageAccessor]")
             auto bs = std::make_shared<BoolStorage>(ONES);
             BoolStorageAccessor bsa(i, n, bs);
             bsa.clear();
-            unsigned long long mask = ~(((1ULL << n) - 1) << i);
-            REQUIRE(bs->to_ullong() == mask);
+            const BoolStorage mask = ~((ONES >> (STORAGE_SIZE - n)) << i);
+            REQUIRE(*bs == mask);
         }
     }
 }
@@ -105,8 +105,8 @@ TEST_CASE("BoolStorageAccessor add doesn't interfere with other bits", "[boolSto
     auto bs = std::make_shared<BoolStorage>(0);
     BoolStorageAccessor bsa(offset, 8, bs);
     bsa.add(a);
-    unsigned long long mask = ~(((1ULL << 8) - 1) << offset);
-    REQUIRE((bs->to_ullong() & mask) == 0);
+    const BoolStorage mask = ~(BoolStorage(0xFF) << offset);
+    REQUIRE((*bs & mask).none());
 }
 
 TEST_CASE("BoolStorageAccessor Throws on invalid access", "[boolStorageAccessor]")
@@ -115,14 +115,14 @@ TEST_CASE("BoolStorageAccessor Throws on invalid access", "[boolStorageAccessor]
     // 0, 0 is a valid accessor, it simply does not modify the buffer
     REQUIRE_NOTHROW(BoolStorageAccessor(0, 0, bs));
 
-    // 64, 92 is not a valid accessor, it is out of bounds
-    REQUIRE_THROWS(BoolStorageAccessor(64, 92, bs));
+    // STORAGE_SIZE, 92 is not a valid accessor, it is out of bounds
+    REQUIRE_THROWS(BoolStorageAccessor(STORAGE_SIZE, 92, bs));
 
-    // 0, 65 is not a valid accessor, it is out of bounds
-    REQUIRE_THROWS(BoolStorageAccessor(0, 65, bs));
+    // 0, STORAGE_SIZE + 1 is not a valid accessor, it is out of bounds
+    REQUIRE_THROWS(BoolStorageAccessor(0, STORAGE_SIZE + 1, bs));
 
-    // 0, 64 is a valid accessor, it modifies the whole buffer
-    REQUIRE_NOTHROW(BoolStorageAccessor(0, 64, bs));
+    // 0, STORAGE_SIZE is a valid accessor, it modifies the whole buffer
+    REQUIRE_NOTHROW(BoolStorageAccessor(0, STORAGE_SIZE, bs));
 }
 
 TEST_CASE("BoolStorageAccessor Throws on invalid dereference", "[boolStorageAccessor]")
@@ -0,0 +1,122 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include "busAccessor.hpp"
+#include "dataBank.hpp"
+#include "socketController.hpp"
+#include <random>
+
+namespace {
+
+std::shared_ptr<BoolStorage> consecutiveWords(size_t count)
+{
+    std::shared_ptr<BoolStorage[]> words(new BoolStorage[count]());
+    return std::shared_ptr<BoolStorage>(words, words.get());
+}
+
+std::vector<BoolStorage> randomValue(std::mt19937_64& rng, size_t bit_count)
+{
+    std::vector<BoolStorage> value((bit_count + STORAGE_SIZE - 1) / STORAGE_SIZE);
+    for (size_t bit = 0; bit < bit_count; bit++) {
+        value[bit / STORAGE_SIZE][bit % STORAGE_SIZE] = rng() & 1;
+    }
+    return value;
+}
+
+}
+
+TEST_CASE("BusAccessor reads and writes bits across words", "[busAccessor]")
+{
+    std::mt19937_64 rng(7);
+    auto words = consecutiveWords(5);
+    const size_t offset = GENERATE(0, 1, 17, STORAGE_SIZE - 1);
+    const size_t bit_count = GENERATE(1, STORAGE_SIZE, 3 * STORAGE_SIZE + 5);
+    BusAccessor bus(offset, bit_count, words);
+    REQUIRE(bus.wordCount() == (bit_count + STORAGE_SIZE - 1) / STORAGE_SIZE);
+
+    const auto value = randomValue(rng, bit_count);
+    bus.set(value);
+    REQUIRE(bus.get() == value);
+    for (size_t bit = 0; bit < bit_count; bit++) {
+        const size_t position = offset + bit;
+        REQUIRE(bus.getBit(bit) == value[bit / STORAGE_SIZE][bit % STORAGE_SIZE]);
+        REQUIRE(words.get()[position / STORAGE_SIZE][position % STORAGE_SIZE] == value[bit / STORAGE_SIZE][bit % STORAGE_SIZE]);
+    }
+
+    // Bits outside the bus stay untouched
+    size_t outside = 0;
+    for (size_t position = 0; position < 5 * STORAGE_SIZE; position++) {
+        if (position < offset || position >= offset + bit_count) {
+            outside += words.get()[position / STORAGE_SIZE][position % STORAGE_SIZE];
+        }
+    }
+    REQUIRE(outside == 0);
+
+    REQUIRE_THROWS(bus.getWord(bus.wordCount()));
+    REQUIRE_THROWS(bus.slice(STORAGE_SIZE - offset - 1, 2));
+}
+
+TEST_CASE("DataBank lends buses as consecutive words", "[busAccessor][dataBank]")
+{
+    DataBank<1> db;
+    auto [small] = db.lendBools(3);
+    auto [bus] = db.lendBus(4 * STORAGE_SIZE + 10);
+    REQUIRE(bus.spannedWords() == 5);
+    REQUIRE(db.size() == 6);
+    REQUIRE(bus.getBuffer().get() == &db.word(0, 1));
+    REQUIRE(db.usedBits(5) == 10);
+
+    // The remainder of the last word is still lent out to single word requests
+    auto [filler] = db.lendBools(STORAGE_SIZE - 10);
+    REQUIRE(filler.getBuffer().get() == &db.word(0, 5));
+    REQUIRE(filler.getBitOffset() == 10);
+
+    // A bus never crosses into another chunk
+    auto [big] = db.lendBus((DataBank<1>::CHUNK_SIZE - 2) * STORAGE_SIZE);
+    REQUIRE(big.getBuffer().get() == &db.word(0, DataBank<1>::CHUNK_SIZE));
+    REQUIRE_THROWS(db.lendBus((DataBank<1>::CHUNK_SIZE + 1) * STORAGE_SIZE));
+}
+
+TEST_CASE("Bus sockets move whole words when aligned", "[busAccessor][socketController]")
+{
+    DataBank<1> db;
+    auto [from] = db.lendBus(64 * STORAGE_SIZE);
+    auto [to] = db.lendBus(64 * STORAGE_SIZE);
+    SocketController sc;
+    sc.addSocket(from, to);
+    REQUIRE(sc.getPlan().size() == 64);
+    for (const auto& transfer : sc.getPlan()) {
+        REQUIRE(transfer.whole_word);
+    }
+
+    std::mt19937_64 rng(3);
+    const auto value = randomValue(rng, 64 * STORAGE_SIZE);
+    from.set(value);
+    sc.tick();
+    REQUIRE(to.get() == value);
+}
+
+TEST_CASE("Bus sockets funnel shift unaligned buses", "[busAccessor][socketController]")
+{
+    std::mt19937_64 rng(11);
+    const size_t from_offset = GENERATE(0, 3, STORAGE_SIZE - 1);
+    const size_t to_offset = GENERATE(0, 5, STORAGE_SIZE / 2);
+    const size_t bit_count = 6 * STORAGE_SIZE - 7;
+    auto from_words = consecutiveWords(7);
+    auto to_words = consecutiveWords(7);
+    BusAccessor from(from_offset, bit_count, from_words);
+    BusAccessor to(to_offset, bit_count, to_words);
+    SocketController sc;
+    sc.addSocket(from, to);
+    if (from_offset != to_offset) {
+        // Every destination word is assembled from at most two source words
+        REQUIRE(sc.getPlan().size() <= 2 * to.spannedWords());
+    }
+
+    for (int i = 0; i < 3; i++) {
+        const auto value = randomValue(rng, bit_count);
+        from.set(value);
+        sc.tick();
+        REQUIRE(to.get() == value);
+    }
+    REQUIRE_THROWS(sc.addSocket(from, BusAccessor(0, bit_count - 1, to_words)));
+}
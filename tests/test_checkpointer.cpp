@@ -0,0 +1,136 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include "checkpointer.hpp"
+#include "circuitGenerators.hpp"
+#include <random>
+#include <sstream>
+
+namespace {
+
+/// @brief A random circuit with feedback, so its state keeps changing while ticking
+struct Simulation {
+    Managers managers;
+    std::shared_ptr<Circuit> circuit;
+
+    explicit Simulation(const std::shared_ptr<CircuitSchematic>& schematic)
+        : circuit(schematic->build(managers))
+    {
+    }
+
+    void randomizeInputs(std::mt19937_64& rng)
+    {
+        for (auto [name, accessor] : circuit->exposed_ports) {
+            accessor.set(rng() & 1);
+        }
+    }
+
+    bool sameState(Simulation& other)
+    {
+        for (uint32_t i = 0; i < managers.arena->size(); i++) {
+            if (managers.arena->word(i) != other.managers.arena->word(i)) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+}
+
+TEST_CASE("Checkpointer restores a full checkpoint into identically built managers", "[checkpointer]")
+{
+    auto schematic = randomSchematic(3, 16, 600, 16, true);
+    Simulation original(schematic);
+    Simulation restored(schematic);
+    std::mt19937_64 rng(1);
+    original.randomizeInputs(rng);
+    for (int i = 0; i < 5; i++) {
+        original.managers.tick();
+    }
+
+    std::stringstream checkpoint;
+    Checkpointer(original.managers).save(checkpoint);
+    Checkpointer checkpointer(restored.managers);
+    checkpointer.restore(checkpoint);
+    REQUIRE(checkpointer.getLastWordCount() == original.managers.arena->size());
+    REQUIRE(restored.sameState(original));
+
+    for (int i = 0; i < 5; i++) {
+        original.managers.tick();
+        restored.managers.tickEventDriven();
+    }
+    REQUIRE(restored.sameState(original));
+}
+
+TEST_CASE("Checkpointer writes only changed words in incremental checkpoints", "[checkpointer]")
+{
+    auto schematic = randomSchematic(4, 16, 2000, 16, true);
+    Simulation original(schematic);
+    std::mt19937_64 rng(2);
+    original.randomizeInputs(rng);
+    Checkpointer writer(original.managers);
+    std::stringstream unused;
+    REQUIRE_THROWS(writer.saveIncremental(unused));
+
+    std::vector<std::string> checkpoints;
+    std::vector<std::vector<BoolStorage>> states;
+    auto record = [&](bool incremental) {
+        std::stringstream out;
+        incremental ? writer.saveIncremental(out) : writer.save(out);
+        checkpoints.push_back(out.str());
+        std::vector<BoolStorage> state;
+        for (uint32_t i = 0; i < original.managers.arena->size(); i++) {
+            state.push_back(original.managers.arena->word(i));
+        }
+        states.push_back(state);
+    };
+    record(false);
+    for (int i = 0; i < 3; i++) {
+        original.managers.tick();
+        record(true);
+        REQUIRE(writer.getLastWordCount() < original.managers.arena->size());
+        REQUIRE(checkpoints.back().size() < checkpoints.front().size());
+    }
+    record(true);
+    REQUIRE(writer.getLastWordCount() == 0);
+
+    // Restoring the chain reproduces every recorded state, even after ticking in between
+    Simulation restored(schematic);
+    Checkpointer reader(restored.managers);
+    for (size_t i = 0; i < checkpoints.size(); i++) {
+        std::stringstream in(checkpoints[i]);
+        reader.restore(in);
+        for (uint32_t word = 0; word < restored.managers.arena->size(); word++) {
+            REQUIRE(restored.managers.arena->word(word) == states[i][word]);
+        }
+        restored.managers.tick();
+    }
+
+    SECTION("Incremental checkpoints have to be restored in order")
+    {
+        Simulation fresh(schematic);
+        Checkpointer out_of_order(fresh.managers);
+        std::stringstream incremental(checkpoints[1]);
+        REQUIRE_THROWS(out_of_order.restore(incremental));
+        std::stringstream full(checkpoints[0]);
+        out_of_order.restore(full);
+        std::stringstream skipped(checkpoints[2]);
+        REQUIRE_THROWS(out_of_order.restore(skipped));
+    }
+}
+
+TEST_CASE("Checkpointer rejects checkpoints of other circuits", "[checkpointer]")
+{
+    Simulation small(randomSchematic(5, 8, 100, 8, false));
+    Simulation large(randomSchematic(5, 8, 2000, 8, false));
+    std::stringstream checkpoint;
+    Checkpointer(small.managers).save(checkpoint);
+    REQUIRE_THROWS(Checkpointer(large.managers).restore(checkpoint));
+
+    std::stringstream truncated(checkpoint.str().substr(0, checkpoint.str().size() - 1));
+    Simulation same(randomSchematic(5, 8, 100, 8, false));
+    REQUIRE_THROWS(Checkpointer(same.managers).restore(truncated));
+
+    std::stringstream garbage(std::string(sizeof(Checkpointer::Header), 'x'));
+    REQUIRE_THROWS(Checkpointer(same.managers).restore(garbage));
+}
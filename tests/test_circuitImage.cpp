@@ -0,0 +1,102 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include "circuitGenerators.hpp"
+#include "circuitImage.hpp"
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+namespace {
+
+std::string imagePath(const std::string& name)
+{
+    return (std::filesystem::temp_directory_path() / ("circuitsim_" + name + ".img")).string();
+}
+
+}
+
+TEST_CASE("CircuitImage simulates like the managers it was written from", "[circuitImage]")
+{
+    auto schematic = randomSchematic(GENERATE(1, 2), 16, 400, 16, GENERATE(false, true));
+    Managers managers;
+    auto circuit = schematic->build(managers);
+    std::mt19937_64 rng(5);
+    for (auto [name, accessor] : circuit->exposed_ports) {
+        accessor.set(rng() & 1);
+    }
+    const std::string path = imagePath("random");
+    CircuitImage::write(path, managers, *circuit);
+
+    CircuitImage image(path);
+    REQUIRE(image.portCount() > 0);
+    REQUIRE(image.transferCount() == managers.socketController->getPlan().size());
+    for (int tick = 0; tick < 8; tick++) {
+        managers.tick();
+        image.tick();
+        for (const auto& [name, accessor] : circuit->bool_storage_access_map) {
+            REQUIRE(image.get(name) == accessor.get());
+        }
+    }
+
+    // Changes stay in the mapping, the file keeps the state it was written with
+    CircuitImage fresh(path);
+    image.set("in_0", 1);
+    fresh.set("in_0", 0);
+    REQUIRE(image.get("in_0") == 1);
+    REQUIRE(fresh.get("in_0") == 0);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("CircuitImage looks up ports by name", "[circuitImage]")
+{
+    auto full_adder = fullAdderSchematic();
+    auto adder = rippleAdderSchematic(full_adder, 8);
+    Managers managers;
+    auto circuit = adder->build(managers);
+    const std::string path = imagePath("adder");
+    CircuitImage::write(path, managers, *circuit);
+    CircuitImage image(path);
+
+    for (size_t i = 1; i < image.portCount(); i++) {
+        REQUIRE(image.portName(i - 1) < image.portName(i));
+    }
+    REQUIRE_THROWS(image.find("missing"));
+
+    // 100 + 57 settles within two ticks per bit of the carry chain
+    const size_t a = 100, b = 57;
+    for (size_t i = 0; i < 8; i++) {
+        image.set("a_" + std::to_string(i), (a >> i) & 1);
+        image.set("b_" + std::to_string(i), (b >> i) & 1);
+    }
+    for (int tick = 0; tick < 32; tick++) {
+        image.tick();
+    }
+    size_t sum = 0;
+    for (size_t i = 0; i < 8; i++) {
+        sum |= image.get("sum_" + std::to_string(i)).to_ullong() << i;
+    }
+    REQUIRE(sum == a + b);
+
+    CircuitImage moved = std::move(image);
+    REQUIRE(moved.get("sum_0") == ((a + b) & 1));
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("CircuitImage rejects invalid files", "[circuitImage]")
+{
+    REQUIRE_THROWS(CircuitImage(imagePath("missing")));
+
+    const std::string path = imagePath("invalid");
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << std::string(sizeof(CircuitImage::Header), 'x');
+    }
+    REQUIRE_THROWS(CircuitImage(path));
+
+    Managers managers;
+    auto circuit = fullAdderSchematic()->build(managers);
+    CircuitImage::write(path, managers, *circuit);
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    REQUIRE_THROWS(CircuitImage(path));
+    std::filesystem::remove(path);
+}
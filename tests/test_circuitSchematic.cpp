@@ -835,4 +835,24 @@ TEST_CASE("2-bit adder with wire bridge io abstraction", "[Circuit][CircuitSchem
         REQUIRE(c->exposed_ports["O_0"].get().to_ulong() == ((a + b) & 0b11));
         REQUIRE(c->bool_storage_access_map["fa_1_carry_0"].get().to_ulong() == ((a + b) >> 2));
     }
-}
\ No newline at end of file
+}
+TEST_CASE("Rebuilding picks up changes to sub-circuit schematics", "[circuitSchematic]")
+{
+    auto inner = CircuitSchematic::create("inner");
+    inner->addNotGate("not1");
+    inner->addExposedPort("not1_a");
+    auto outer = CircuitSchematic::create("outer");
+    outer->addSubCircuit("sub", inner);
+
+    Managers m;
+    auto before = outer->build(m);
+    REQUIRE(before->bool_storage_access_map.count("sub_not1_a") == 1);
+    REQUIRE(before->bool_storage_access_map.count("sub_not1_b") == 0);
+
+    inner->addExposedPort("not1_b");
+    auto after = outer->build(m);
+    REQUIRE(after->bool_storage_access_map.count("sub_not1_b") == 1);
+    after->bool_storage_access_map["sub_not1_a"].set(0);
+    m.tick();
+    REQUIRE(after->bool_storage_access_map["sub_not1_b"].get() == 1);
+}
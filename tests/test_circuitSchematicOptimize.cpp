@@ -0,0 +1,183 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include "circuitGenerators.hpp"
+#include <random>
+
+namespace {
+
+size_t gateCount(Managers& managers)
+{
+    return managers.andGate->getDataBank().getUsage().bits_used / 3
+        + managers.notGate->getDataBank().getUsage().bits_used / 2
+        + managers.orGate->getDataBank().getUsage().bits_used / 3
+        + managers.xorGate->getDataBank().getUsage().bits_used / 3;
+}
+
+}
+
+TEST_CASE("optimize collapses NOT chains and removes dead gates", "[circuitSchematic]")
+{
+    auto cs = CircuitSchematic::create("chain");
+    cs->addWireBridge({ { "in", { 1 } } });
+    cs->addWireBridge({ { "out", { 1 } } });
+    cs->addWireBridge({ { "unused", { 1 } } });
+    cs->addExposedPort("in_0");
+    cs->addExposedPort("out_0");
+    std::string previous = "in_0";
+    for (int i = 0; i < 5; i++) {
+        const std::string gate = "not" + std::to_string(i);
+        cs->addNotGate(gate);
+        cs->addConnection(previous, gate + "_a");
+        previous = gate + "_b";
+    }
+    cs->addConnection(previous, "out_0");
+    cs->addAndGate("dead");
+    cs->addConnection("in_0", "dead_a");
+    cs->addConnection("dead_c", "unused_0");
+    cs->addAlias("dead_c", "dead_output");
+
+    const auto stats = cs->optimize();
+    REQUIRE(stats.removed_gates == 5);
+    REQUIRE(stats.removed_bridges == 1);
+
+    Managers managers;
+    auto circuit = cs->build(managers);
+    REQUIRE(gateCount(managers) == 1);
+    REQUIRE(circuit->bool_storage_access_map.count("dead_output") == 0);
+    for (bool value : { false, true, false }) {
+        circuit->exposed_ports["in_0"].set(value);
+        managers.tickLevelized();
+        REQUIRE(circuit->exposed_ports["out_0"].get()[0] == !value);
+    }
+}
+
+TEST_CASE("optimize folds constants and merges equal gates", "[circuitSchematic]")
+{
+    auto cs = CircuitSchematic::create("constants");
+    cs->addWireBridge({ { "in", { 1, 1 } } });
+    cs->addWireBridge({ { "out", { 1, 1, 1, 1 } } });
+    for (const char* port : { "in_0", "in_1", "out_0", "out_1", "out_2", "out_3" }) {
+        cs->addExposedPort(port);
+    }
+    // The undriven input of an AND gate reads 0, OR with 1 is 1
+    cs->addAndGate("zero");
+    cs->addConnection("in_0", "zero_a");
+    cs->addNotGate("one");
+    cs->addConnection("zero_c", "one_a");
+    cs->addOrGate("or");
+    cs->addConnection("in_1", "or_a");
+    cs->addConnection("one_b", "or_b");
+    cs->addConnection("or_c", "out_0");
+    // Two XOR gates of the same inputs in swapped order
+    cs->addXorGate("x1");
+    cs->addXorGate("x2");
+    cs->addConnection("in_0", "x1_a");
+    cs->addConnection("in_1", "x1_b");
+    cs->addConnection("in_1", "x2_a");
+    cs->addConnection("in_0", "x2_b");
+    cs->addConnection("x1_c", "out_1");
+    cs->addConnection("x2_c", "out_2");
+    // XOR with 1 of an inverted input is the input itself
+    cs->addNotGate("inverted");
+    cs->addConnection("in_0", "inverted_a");
+    cs->addXorGate("x3");
+    cs->addConnection("inverted_b", "x3_a");
+    cs->addConnection("or_c", "x3_b");
+    cs->addConnection("x3_c", "out_3");
+
+    cs->optimize();
+    Managers managers;
+    auto circuit = cs->build(managers);
+    // Only one XOR gate and the source of constant ones are left
+    REQUIRE(gateCount(managers) == 2);
+    for (int value = 0; value < 4; value++) {
+        const bool in_0 = value & 1, in_1 = value & 2;
+        circuit->exposed_ports["in_0"].set(in_0);
+        circuit->exposed_ports["in_1"].set(in_1);
+        managers.tickLevelized();
+        REQUIRE(circuit->exposed_ports["out_0"].get()[0] == true);
+        REQUIRE(circuit->exposed_ports["out_1"].get()[0] == (in_0 != in_1));
+        REQUIRE(circuit->exposed_ports["out_2"].get()[0] == (in_0 != in_1));
+        REQUIRE(circuit->exposed_ports["out_3"].get()[0] == in_0);
+    }
+}
+
+TEST_CASE("optimize keeps undriven connections that overwrite a gate output", "[circuitSchematic]")
+{
+    for (bool optimize : { false, true }) {
+        auto cs = CircuitSchematic::create("overwrite");
+        cs->addWireBridge({ { "z", { 1 } } });
+        cs->addWireBridge({ { "o", { 1 } } });
+        cs->addExposedPort("o_0");
+        // The NOT gate computes 1, then the undriven bridge is copied over it in the same tick
+        cs->addNotGate("n");
+        cs->addConnection("z_0", "n_b");
+        cs->addConnection("n_b", "o_0");
+        if (optimize) {
+            cs->optimize();
+        }
+
+        Managers managers;
+        auto circuit = cs->build(managers);
+        for (int i = 0; i < 4; i++) {
+            managers.tick();
+        }
+        INFO("optimize " << optimize);
+        REQUIRE(circuit->exposed_ports["o_0"].get()[0] == false);
+    }
+}
+
+TEST_CASE("optimize preserves the settled outputs of random circuits", "[circuitSchematic]")
+{
+    const uint64_t seed = GENERATE(range(1, 9));
+    auto original = randomSchematic(seed, 8, 400, 16, false);
+    auto optimized = randomSchematic(seed, 8, 400, 16, false);
+    const auto stats = optimized->optimize();
+    REQUIRE(stats.removed_gates > 0);
+    // Optimizing again finds nothing left to remove
+    REQUIRE(optimized->optimize().removed_gates == 0);
+
+    Managers original_managers, optimized_managers;
+    auto original_circuit = original->build(original_managers);
+    auto optimized_circuit = optimized->build(optimized_managers);
+    REQUIRE(gateCount(optimized_managers) < gateCount(original_managers));
+
+    std::mt19937_64 rng(seed);
+    for (int round = 0; round < 16; round++) {
+        for (int i = 0; i < 8; i++) {
+            const bool value = rng() & 1;
+            original_circuit->exposed_ports["in_" + std::to_string(i)].set(value);
+            optimized_circuit->exposed_ports["in_" + std::to_string(i)].set(value);
+        }
+        original_managers.tickLevelized();
+        optimized_managers.tickLevelized();
+        for (int i = 0; i < 16; i++) {
+            const std::string port = "out_" + std::to_string(i);
+            INFO(port);
+            REQUIRE(optimized_circuit->exposed_ports[port].get() == original_circuit->exposed_ports[port].get());
+        }
+    }
+}
+
+TEST_CASE("optimize keeps shared sub-circuits working", "[circuitSchematic]")
+{
+    auto full_adder = fullAdderSchematic();
+    auto adder = rippleAdderSchematic(full_adder, 8);
+    adder->optimize();
+
+    Managers managers;
+    auto circuit = adder->build(managers);
+    const size_t a = 201, b = 99;
+    for (size_t i = 0; i < 8; i++) {
+        circuit->exposed_ports["a_" + std::to_string(i)].set((a >> i) & 1);
+        circuit->exposed_ports["b_" + std::to_string(i)].set((b >> i) & 1);
+    }
+    for (int i = 0; i < 32; i++) {
+        managers.tick();
+    }
+    size_t sum = circuit->exposed_ports["carry_0"].get()[0] << 8;
+    for (size_t i = 0; i < 8; i++) {
+        sum |= circuit->exposed_ports["sum_" + std::to_string(i)].get()[0] << i;
+    }
+    REQUIRE(sum == a + b);
+}
@@ -0,0 +1,125 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include "circuitGenerators.hpp"
+#include <random>
+
+namespace {
+
+BuildOptions coalescing()
+{
+    BuildOptions options;
+    options.coalesce_sockets = true;
+    return options;
+}
+
+}
+
+TEST_CASE("Coalescing shares the storage of single driven bridge ports", "[circuitSchematic]")
+{
+    auto cs = CircuitSchematic::create("chain");
+    cs->addWireBridge({ { "in", { 1 } } });
+    cs->addWireBridge({ { "mid", { 1 } } });
+    cs->addWireBridge({ { "out", { 1 } } });
+    cs->addNotGate("not");
+    cs->addExposedPort("in_0");
+    cs->addExposedPort("out_0");
+    cs->addConnection("in_0", "not_a");
+    cs->addConnection("not_b", "mid_0");
+    cs->addConnection("mid_0", "out_0");
+
+    Managers managers;
+    auto circuit = cs->build(managers, coalescing());
+    // Only the socket into the gate input is left, mid and out read the gate output directly
+    REQUIRE(managers.socketController->getSockets().size() == 1);
+    REQUIRE(managers.random_access_data_bank->getUsage().bits_used == 1);
+    REQUIRE(circuit->bool_storage_access_map["out_0"].getBuffer() == circuit->bool_storage_access_map["not_b"].getBuffer());
+    for (bool value : { true, false, true }) {
+        circuit->exposed_ports["in_0"].set(value);
+        managers.tick();
+        managers.tick();
+        REQUIRE(circuit->exposed_ports["out_0"].get()[0] == !value);
+    }
+}
+
+TEST_CASE("Coalescing keeps sockets where a copy is needed", "[circuitSchematic]")
+{
+    auto cs = CircuitSchematic::create("copies");
+    cs->addWireBridge({ { "twice", { 1 } } });
+    cs->addWireBridge({ { "view", { 1 } }, { "other", { 1 } } });
+    cs->addWireBridge({ { "ring", { 1, 1 } } });
+    cs->addNotGate("a");
+    cs->addNotGate("b");
+    // Two drivers, a multi view bridge and a loop without an outside driver
+    cs->addConnection("a_b", "twice_0");
+    cs->addConnection("b_b", "twice_0");
+    cs->addConnection("a_b", "view_0");
+    cs->addConnection("ring_0", "ring_1");
+    cs->addConnection("ring_1", "ring_0");
+
+    Managers managers;
+    auto circuit = cs->build(managers, coalescing());
+    REQUIRE(managers.socketController->getSockets().size() == 4);
+    auto& ports = circuit->bool_storage_access_map;
+    REQUIRE(ports["view_0"].getBuffer() != ports["a_b"].getBuffer());
+    // The loop is broken at one port, the other one shares its bits
+    REQUIRE(ports["ring_0"].getBuffer() == ports["ring_1"].getBuffer());
+    REQUIRE(ports["ring_0"].getBitOffset() == ports["ring_1"].getBitOffset());
+
+    // Ports of different sizes are still rejected instead of sharing storage
+    cs->addWireBridge({ { "wide", { 4 } } });
+    cs->addWireBridge({ { "narrow", { 1 } } });
+    cs->addConnection("wide_0", "narrow_0");
+    Managers mismatched;
+    REQUIRE_THROWS(cs->build(mismatched, coalescing()));
+}
+
+TEST_CASE("Coalescing preserves the results of circuits", "[circuitSchematic]")
+{
+    SECTION("Ripple adder with shared full adders")
+    {
+        auto full_adder = fullAdderSchematic();
+        auto adder = rippleAdderSchematic(full_adder, 16);
+        Managers plain, coalesced;
+        auto plain_circuit = adder->build(plain);
+        auto coalesced_circuit = adder->build(coalesced, coalescing());
+        REQUIRE(coalesced.socketController->getSockets().size() < plain.socketController->getSockets().size());
+
+        const size_t a = 40000, b = 31337;
+        for (size_t i = 0; i < 16; i++) {
+            coalesced_circuit->exposed_ports["a_" + std::to_string(i)].set((a >> i) & 1);
+            coalesced_circuit->exposed_ports["b_" + std::to_string(i)].set((b >> i) & 1);
+        }
+        for (int i = 0; i < 64; i++) {
+            coalesced.tick();
+        }
+        size_t sum = coalesced_circuit->exposed_ports["carry_0"].get()[0] << 16;
+        for (size_t i = 0; i < 16; i++) {
+            sum |= coalesced_circuit->exposed_ports["sum_" + std::to_string(i)].get()[0] << i;
+        }
+        REQUIRE(sum == a + b);
+    }
+
+    SECTION("Random circuits")
+    {
+        const uint64_t seed = GENERATE(range(1, 5));
+        auto schematic = randomSchematic(seed, 8, 300, 16, false);
+        Managers plain, coalesced;
+        auto plain_circuit = schematic->build(plain);
+        auto coalesced_circuit = schematic->build(coalesced, coalescing());
+        std::mt19937_64 rng(seed);
+        for (int round = 0; round < 8; round++) {
+            for (int i = 0; i < 8; i++) {
+                const bool value = rng() & 1;
+                plain_circuit->exposed_ports["in_" + std::to_string(i)].set(value);
+                coalesced_circuit->exposed_ports["in_" + std::to_string(i)].set(value);
+            }
+            plain.tickLevelized();
+            coalesced.tickLevelized();
+            for (int i = 0; i < 16; i++) {
+                const std::string port = "out_" + std::to_string(i);
+                INFO(port);
+                REQUIRE(coalesced_circuit->exposed_ports[port].get() == plain_circuit->exposed_ports[port].get());
+            }
+        }
+    }
+}
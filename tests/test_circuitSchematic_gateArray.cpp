@@ -0,0 +1,84 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include "circuitSchematic.hpp"
+#include <random>
+
+TEST_CASE("Gate arrays connect to buses with single transfers", "[circuitSchematic]")
+{
+    auto cs = CircuitSchematic::create("arrays");
+    cs->addWireBridge({ { "x", { STORAGE_SIZE } } });
+    cs->addWireBridge({ { "y", { STORAGE_SIZE } } });
+    cs->addWireBridge({ { "sum", { STORAGE_SIZE } } });
+    cs->addWireBridge({ { "carry", { STORAGE_SIZE } } });
+    cs->addXorGateArray("half_sum", STORAGE_SIZE);
+    cs->addAndGateArray("half_carry", STORAGE_SIZE);
+    for (const char* port : { "x_0", "y_0", "sum_0", "carry_0" }) {
+        cs->addExposedPort(port);
+    }
+    cs->addConnection("x_0", "half_sum_a");
+    cs->addConnection("y_0", "half_sum_b");
+    cs->addConnection("x_0", "half_carry_a");
+    cs->addConnection("y_0", "half_carry_b");
+    cs->addConnection("half_sum_c", "sum_0");
+    cs->addConnection("half_carry_c", "carry_0");
+
+    Managers managers;
+    auto circuit = cs->build(managers);
+    REQUIRE(managers.socketController->getSockets().size() == 6);
+    const auto& plan = managers.socketController->getPlan();
+    REQUIRE(plan.size() == 6);
+    for (const auto& transfer : plan) {
+        REQUIRE(transfer.whole_word);
+    }
+
+    std::mt19937_64 rng(1);
+    for (int i = 0; i < 4; i++) {
+        const BoolStorage x = rng(), y = rng();
+        circuit->exposed_ports["x_0"].set(x);
+        circuit->exposed_ports["y_0"].set(y);
+        managers.tick();
+        managers.tick();
+        REQUIRE(circuit->exposed_ports["sum_0"].get() == (x ^ y));
+        REQUIRE(circuit->exposed_ports["carry_0"].get() == (x & y));
+        REQUIRE(circuit->bool_storage_access_map["half_sum_5_c"].get()[0] == (x[5] ^ y[5]));
+    }
+}
+
+TEST_CASE("Gates of an array can be connected one by one", "[circuitSchematic]")
+{
+    auto cs = CircuitSchematic::create("bits");
+    cs->addWireBridge({ { "in", { 1, 1, 1 } } });
+    cs->addWireBridge({ { "out", { 3 } } });
+    cs->addNotGateArray("inverted", 3);
+    cs->addOrGate("or");
+    for (const char* port : { "in_0", "in_1", "in_2", "out_0" }) {
+        cs->addExposedPort(port);
+    }
+    cs->addConnection("in_0", "inverted_0_a");
+    cs->addConnection("in_1", "inverted_1_a");
+    cs->addConnection("in_1", "or_a");
+    cs->addConnection("in_2", "or_b");
+    cs->addConnection("or_c", "inverted_2_a");
+    cs->addConnection("inverted_b", "out_0");
+
+    auto check = [&]() {
+        Managers managers;
+        auto circuit = cs->build(managers);
+        REQUIRE(circuit->bool_storage_access_map["inverted_a"].getSocketSize() == 3);
+        for (unsigned value = 0; value < 8; value++) {
+            for (unsigned i = 0; i < 3; i++) {
+                circuit->exposed_ports["in_" + std::to_string(i)].set((value >> i) & 1);
+            }
+            managers.tickLevelized();
+            const unsigned expected = (~value & 1) | (~value & 2) | (((value >> 1) | (value >> 2)) & 1 ? 0 : 4);
+            REQUIRE(circuit->exposed_ports["out_0"].get().to_ulong() == expected);
+        }
+    };
+    check();
+    // The optimizer keeps the arrays and the gates feeding them
+    REQUIRE(cs->optimize().removed_gates == 0);
+    check();
+
+    REQUIRE_THROWS(cs->addAndGateArray("empty", 0));
+    REQUIRE_THROWS(cs->addAndGateArray("too_wide", STORAGE_SIZE + 1));
+}
@@ -0,0 +1,86 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include "circuitGenerators.hpp"
+#include <algorithm>
+#include <random>
+
+namespace {
+
+BuildOptions placing()
+{
+    BuildOptions options;
+    options.place_gates = true;
+    return options;
+}
+
+}
+
+TEST_CASE("Placement lends connected gates next to each other", "[circuitSchematic]")
+{
+    // A chain of NOT gates declared in random order, spanning four chunks of the bank at any word width
+    const size_t length = 4 * StorageArena::CHUNK_SIZE * STORAGE_SIZE;
+    std::vector<size_t> order(length);
+    for (size_t i = 0; i < length; i++) {
+        order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), std::mt19937_64(1));
+    auto cs = CircuitSchematic::create("chain");
+    cs->addWireBridge({ { "in", { 1 } } });
+    cs->addWireBridge({ { "out", { 1 } } });
+    cs->addExposedPort("in_0");
+    cs->addExposedPort("out_0");
+    for (size_t i : order) {
+        cs->addNotGate("n" + std::to_string(i));
+    }
+    cs->addConnection("in_0", "n0_a");
+    for (size_t i = 1; i < length; i++) {
+        cs->addConnection("n" + std::to_string(i - 1) + "_b", "n" + std::to_string(i) + "_a");
+    }
+    cs->addConnection("n" + std::to_string(length - 1) + "_b", "out_0");
+
+    Managers declared, placed;
+    auto declared_circuit = cs->build(declared);
+    auto placed_circuit = cs->build(placed, placing());
+    const auto declared_locality = declared.socketController->getLocality(*declared.arena);
+    const auto placed_locality = placed.socketController->getLocality(*placed.arena);
+    // The inputs and outputs of a gate bank lie in chunks of their own, so CHUNK_SIZE is the floor
+    REQUIRE(placed_locality.distance <= StorageArena::CHUNK_SIZE + 1);
+    REQUIRE(declared_locality.distance > 2 * StorageArena::CHUNK_SIZE);
+    REQUIRE(placed_locality.stride < 1);
+    REQUIRE(declared_locality.stride > StorageArena::CHUNK_SIZE);
+    // Sockets between the same pair of words merge into single transfers
+    REQUIRE(placed.socketController->getPlan().size() < declared.socketController->getPlan().size() / 4);
+
+    // Only the storage moved, the names still refer to the same gates
+    placed_circuit->exposed_ports["in_0"].set(1);
+    placed.tickLevelized();
+    REQUIRE(placed_circuit->exposed_ports["out_0"].get()[0] == 1);
+    REQUIRE(placed_circuit->bool_storage_access_map["n0_b"].get()[0] == 0);
+    REQUIRE(placed_circuit->bool_storage_access_map["n1_b"].get()[0] == 1);
+}
+
+TEST_CASE("Placement preserves the results of circuits", "[circuitSchematic]")
+{
+    const uint64_t seed = GENERATE(range(1, 5));
+    auto schematic = randomSchematic(seed, 8, 300, 16, false);
+    Managers declared, placed;
+    auto declared_circuit = schematic->build(declared);
+    BuildOptions options = placing();
+    options.coalesce_sockets = true;
+    auto placed_circuit = schematic->build(placed, options);
+    std::mt19937_64 rng(seed);
+    for (int round = 0; round < 8; round++) {
+        for (int i = 0; i < 8; i++) {
+            const bool value = rng() & 1;
+            declared_circuit->exposed_ports["in_" + std::to_string(i)].set(value);
+            placed_circuit->exposed_ports["in_" + std::to_string(i)].set(value);
+        }
+        declared.tickLevelized();
+        placed.tickLevelized();
+        for (int i = 0; i < 16; i++) {
+            const std::string port = "out_" + std::to_string(i);
+            INFO(port);
+            REQUIRE(placed_circuit->exposed_ports[port].get() == declared_circuit->exposed_ports[port].get());
+        }
+    }
+}
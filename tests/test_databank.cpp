@@ -103,4 +103,68 @@ TEST_CASE("DataBank's storages do not interfere with each other", "[dataBank]")
     for (size_t i = 0; i < 39; i++) {
         REQUIRE(storages[i].lock()->to_ullong() == i);
     }
-}
\ No newline at end of file
+}
+TEST_CASE("DataBank exposes its words as contiguous spans", "[dataBank]")
+{
+    DataBank<2> db;
+    std::vector<std::array<std::weak_ptr<BoolStorage>, 2>> storages;
+    for (size_t i = 0; i < DataBank<2>::CHUNK_SIZE + 3; i++) {
+        storages.emplace_back(db.lendStorage());
+        *storages.back()[0].lock() = i;
+    }
+    REQUIRE(db.size() == DataBank<2>::CHUNK_SIZE + 3);
+
+    size_t index = 0;
+    size_t spans = 0;
+    db.forEachSpan([&](const DataBank<2>::Span& span, size_t size) {
+        for (size_t i = 0; i < size; i++, index++) {
+            REQUIRE(span[0][i].to_ullong() == index);
+            REQUIRE(&span[0][i] == storages[index][0].lock().get());
+            REQUIRE(&span[1][i] == storages[index][1].lock().get());
+            span[1][i] = index * 2;
+        }
+        spans++;
+    });
+    REQUIRE(index == db.size());
+    REQUIRE(spans == 2);
+    REQUIRE(db.word(1, DataBank<2>::CHUNK_SIZE + 1).to_ullong() == (DataBank<2>::CHUNK_SIZE + 1) * 2);
+}
+
+TEST_CASE("DataBank packs lent bools densely", "[dataBank]")
+{
+    DataBank<3> db;
+    for (size_t i = 0; i < STORAGE_SIZE * 100; i++) {
+        db.lendBools(1);
+    }
+    REQUIRE(db.size() == 100);
+
+    // A larger request opens a new word, which then gets filled by the smaller ones
+    DataBank<1> mixed;
+    auto [wide] = mixed.lendBools(STORAGE_SIZE - 8);
+    auto [other_wide] = mixed.lendBools(STORAGE_SIZE - 8);
+    REQUIRE(mixed.size() == 2);
+    for (size_t i = 0; i < 16; i++) {
+        mixed.lendBools(1);
+    }
+    REQUIRE(mixed.size() == 2);
+    REQUIRE(mixed.usedBits(0) == STORAGE_SIZE);
+    REQUIRE(mixed.usedBits(1) == STORAGE_SIZE);
+    mixed.lendBools(1);
+    REQUIRE(mixed.size() == 3);
+}
+
+TEST_CASE("DataBank can lend many bools at once", "[dataBank]")
+{
+    DataBank<2> db;
+    auto lent = db.lendBools(STORAGE_SIZE + 5, 1);
+    REQUIRE(lent.size() == STORAGE_SIZE + 5);
+    REQUIRE(db.size() == 2);
+    for (size_t i = 0; i < lent.size(); i++) {
+        lent[i][0].set(i % 2);
+        lent[i][1].set(1);
+    }
+    for (size_t i = 0; i < lent.size(); i++) {
+        REQUIRE(lent[i][0].get() == i % 2);
+        REQUIRE(lent[i][1].get() == 1);
+    }
+}
@@ -0,0 +1,69 @@
+#include "circuitGenerators.hpp"
+#include "managers.hpp"
+#include <catch2/catch_amalgamated.hpp>
+
+TEST_CASE("Event driven ticks match full sweep ticks", "[eventScheduler][Manager]")
+{
+    const bool feedback = GENERATE(false, true);
+    const uint64_t seed = GENERATE(1, 2, 3);
+    auto cs = randomSchematic(seed, 8, 200, 16, feedback);
+    Managers full, event;
+    auto full_circuit = cs->build(full);
+    auto event_circuit = cs->build(event);
+    std::mt19937_64 rng(seed);
+
+    for (size_t t = 0; t < 60; t++) {
+        if (t % 10 == 0) {
+            const std::string port = "in_" + std::to_string(rng() % 8);
+            const bool value = rng() % 2;
+            full_circuit->exposed_ports[port].set(value);
+            event_circuit->exposed_ports[port].set(value);
+        }
+        full.tick();
+        event.tickEventDriven();
+        REQUIRE(circuitState(*full_circuit) == circuitState(*event_circuit));
+    }
+}
+
+TEST_CASE("Event driven ticks only evaluate changed logic", "[eventScheduler][Manager]")
+{
+    auto full_adder = fullAdderSchematic();
+    auto cs = rippleAdderSchematic(full_adder, 32);
+    Managers m;
+    auto circuit = cs->build(m);
+    for (size_t i = 0; i < 100; i++) {
+        m.tickEventDriven();
+    }
+    REQUIRE(m.eventScheduler->getLastActivity().gate_words == 0);
+    REQUIRE(m.eventScheduler->getLastActivity().transfers == 0);
+
+    circuit->exposed_ports["a_0"].set(1);
+    m.tickEventDriven();
+    REQUIRE(m.eventScheduler->getLastActivity().transfers > 0);
+    for (size_t i = 0; i < 20; i++) {
+        m.tickEventDriven();
+    }
+    REQUIRE(circuit->exposed_ports["sum_0"].get() == 1);
+    REQUIRE(m.eventScheduler->getLastActivity().transfers == 0);
+}
+
+TEST_CASE("Event driven ticks accept reported writes", "[eventScheduler][Manager]")
+{
+    auto full_adder = fullAdderSchematic();
+    auto cs = rippleAdderSchematic(full_adder, 4);
+    Managers m;
+    auto circuit = cs->build(m);
+    m.eventScheduler->setExternalWriteDetection(false);
+    m.tickEventDriven();
+
+    circuit->exposed_ports["a_1"].set(1);
+    circuit->exposed_ports["b_2"].set(1);
+    m.eventScheduler->notifyWrite(circuit->exposed_ports["a_1"]);
+    m.eventScheduler->notifyWrite(circuit->exposed_ports["b_2"]);
+    for (size_t i = 0; i < 40; i++) {
+        m.tickEventDriven();
+    }
+    REQUIRE(circuit->exposed_ports["sum_1"].get() == 1);
+    REQUIRE(circuit->exposed_ports["sum_2"].get() == 1);
+    REQUIRE(circuit->exposed_ports["sum_0"].get() == 0);
+}
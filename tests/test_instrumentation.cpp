@@ -0,0 +1,73 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include "circuitGenerators.hpp"
+#include "instrumentation.hpp"
+#include "managers.hpp"
+#include <algorithm>
+#include <sstream>
+
+TEST_CASE("Instrumentation records the difference of the counters over a tick", "[instrumentation]")
+{
+    std::array<PhaseStats, TICK_PHASE_COUNT> phases {};
+    Instrumentation::PhaseSources sources;
+    for (size_t i = 0; i < TICK_PHASE_COUNT; i++) {
+        sources[i] = &phases[i];
+    }
+    Instrumentation instrumentation;
+    instrumentation.setCapacity(2);
+    for (uint64_t tick = 0; tick < 3; tick++) {
+        instrumentation.beginTick(sources);
+        phases[0].words += 2;
+        phases[4].bits_changed += tick;
+        instrumentation.endTick(sources);
+    }
+
+    REQUIRE(instrumentation.getSeries().size() == 2);
+    REQUIRE(instrumentation.getSeries().front().tick == 1);
+    REQUIRE(instrumentation.getSeries().back().phase(TickPhase::AndGates).words == 2);
+    REQUIRE(instrumentation.getSeries().back().phase(TickPhase::Sockets).bits_changed == 2);
+    REQUIRE(instrumentation.getTotals().tick == 3);
+    REQUIRE(instrumentation.getTotals().phase(TickPhase::AndGates).words == 6);
+    REQUIRE(instrumentation.getTotals().phase(TickPhase::Sockets).bits_changed == 3);
+
+    std::ostringstream csv;
+    instrumentation.writeCsv(csv);
+    const std::string csv_text = csv.str();
+    REQUIRE(csv_text.rfind("tick,cycles,accessor_locks,and_cycles,and_words,and_bits_changed", 0) == 0);
+    REQUIRE(std::count(csv_text.begin(), csv_text.end(), '\n') == 3);
+
+    std::ostringstream json;
+    instrumentation.writeJson(json);
+    REQUIRE(json.str().rfind("{\"totals\":{\"tick\":3,", 0) == 0);
+    REQUIRE(json.str().find("\"sockets\":{\"cycles\":0,\"words\":0,\"bits_changed\":2}") != std::string::npos);
+
+    instrumentation.clear();
+    REQUIRE(instrumentation.getSeries().empty());
+    REQUIRE(instrumentation.getTotals().tick == 0);
+}
+
+TEST_CASE("Managers::tick() feeds the instrumentation when it is enabled", "[instrumentation]")
+{
+    auto full_adder = fullAdderSchematic();
+    Managers m;
+    auto circuit = full_adder->build(m);
+    circuit->exposed_ports["input_0"].set(1);
+    m.tick();
+    m.tick();
+
+    const auto& series = m.instrumentation->getSeries();
+    if (!INSTRUMENTATION_ENABLED) {
+        REQUIRE(series.empty());
+        REQUIRE(m.socketController->getStats().words == 0);
+        return;
+    }
+    REQUIRE(series.size() == 2);
+    for (const auto& stats : series) {
+        REQUIRE(stats.phase(TickPhase::AndGates).words == m.andGate->getDataBank().size());
+        REQUIRE(stats.phase(TickPhase::Sockets).words == m.socketController->getPlan().size());
+    }
+    // The first tick moves the input into the gates, the second one produces the results
+    REQUIRE(series[0].phase(TickPhase::Sockets).bits_changed > 0);
+    REQUIRE(series[1].phase(TickPhase::XorGates).bits_changed > 0);
+    REQUIRE(m.instrumentation->getTotals().phase(TickPhase::Sockets).words == 2 * m.socketController->getPlan().size());
+}
@@ -0,0 +1,63 @@
+#include "circuitGenerators.hpp"
+#include "managers.hpp"
+#include <catch2/catch_amalgamated.hpp>
+
+TEST_CASE("Levelized ticks settle a ripple carry adder at once", "[levelizedScheduler][Manager]")
+{
+    auto full_adder = fullAdderSchematic();
+    auto cs = rippleAdderSchematic(full_adder, 16);
+    Managers m;
+    auto circuit = cs->build(m);
+    // Two gates per bit on the carry chain, plus the sum and carry logic of the first bit
+    REQUIRE(m.levelizedScheduler->getDepth(m) == 2 * 16 + 1);
+
+    const size_t a = GENERATE(0, 1, 0x7FFF, 0xFFFF, 0x1234);
+    const size_t b = GENERATE(0, 1, 0xFFFF, 0xABCD);
+    for (size_t i = 0; i < 16; i++) {
+        circuit->exposed_ports["a_" + std::to_string(i)].set((a >> i) & 1);
+        circuit->exposed_ports["b_" + std::to_string(i)].set((b >> i) & 1);
+    }
+    m.tickLevelized();
+    size_t sum = circuit->exposed_ports["carry_0"].get().to_ulong() << 16;
+    for (size_t i = 0; i < 16; i++) {
+        sum |= circuit->exposed_ports["sum_" + std::to_string(i)].get().to_ulong() << i;
+    }
+    REQUIRE(sum == a + b);
+}
+
+TEST_CASE("Levelized ticks reach the state repeated ticks converge to", "[levelizedScheduler][Manager]")
+{
+    const uint64_t seed = GENERATE(1, 2, 3, 4);
+    auto cs = randomSchematic(seed, 8, 300, 16, false);
+    Managers swept, levelized;
+    auto swept_circuit = cs->build(swept);
+    auto levelized_circuit = cs->build(levelized);
+    std::mt19937_64 rng(seed);
+    for (size_t round = 0; round < 3; round++) {
+        for (size_t i = 0; i < 8; i++) {
+            const bool value = rng() % 2;
+            swept_circuit->exposed_ports["in_" + std::to_string(i)].set(value);
+            levelized_circuit->exposed_ports["in_" + std::to_string(i)].set(value);
+        }
+        for (size_t t = 0; t < 400; t++) {
+            swept.tick();
+        }
+        levelized.tickLevelized();
+        REQUIRE(circuitState(*swept_circuit) == circuitState(*levelized_circuit));
+    }
+}
+
+TEST_CASE("Levelized ticks detect combinational loops", "[levelizedScheduler][Manager]")
+{
+    auto cs = CircuitSchematic::create("ring");
+    cs->addNotGate("not1");
+    cs->addNotGate("not2");
+    cs->addNotGate("not3");
+    cs->addConnection("not1_b", "not2_a");
+    cs->addConnection("not2_b", "not3_a");
+    cs->addConnection("not3_b", "not1_a");
+    Managers m;
+    cs->build(m);
+    REQUIRE_THROWS(m.tickLevelized());
+    REQUIRE_NOTHROW(m.tick());
+}
@@ -0,0 +1,100 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include "circuitGenerators.hpp"
+#include "memoryReport.hpp"
+
+TEST_CASE("MemoryReport accounts managers and circuits by category", "[memoryReport]")
+{
+    Managers managers;
+    REQUIRE(MemoryReport(managers).total() == MemoryReport(managers).bank_metadata);
+
+    auto schematic = randomSchematic(1, 16, 1000, 16, false);
+    auto first = schematic->build(managers);
+    auto second = schematic->build(managers);
+    managers.tick();
+
+    MemoryReport report(managers);
+    REQUIRE(report.bank_words == managers.arena->size() * sizeof(BoolStorage));
+    REQUIRE(report.sockets >= managers.socketController->getSockets().size() * sizeof(SocketController::Socket));
+    REQUIRE(report.accessors == 0);
+    REQUIRE(report.banks.size() == 5);
+    REQUIRE(report.banks[1].name == "and");
+    size_t gate_bits = 0;
+    for (const auto& bank : report.banks) {
+        REQUIRE(bank.bits_used <= bank.bits_allocated);
+        gate_bits += bank.bits_used;
+    }
+    REQUIRE(gate_bits > 0);
+
+    report.addCircuit(*first);
+    const size_t names = report.names;
+    const size_t accessors = report.accessors;
+    REQUIRE(names > 0);
+    REQUIRE(accessors >= first->bool_storage_access_map.getLayout().slotCount() * sizeof(StorageHandle));
+    REQUIRE(accessors < first->bool_storage_access_map.getLayout().slotCount() * sizeof(BoolStorageAccessor));
+    // The second circuit shares the names of the first one, but has accessors of its own
+    report.addCircuit(*second);
+    REQUIRE(report.names == names);
+    REQUIRE(report.accessors == 2 * accessors);
+    REQUIRE(report.total() == report.bank_words + report.bank_metadata + report.sockets + report.accessors + report.names + report.circuits);
+}
+
+TEST_CASE("MemoryReport counts the sub-circuit tree", "[memoryReport]")
+{
+    auto full_adder = fullAdderSchematic();
+    auto adder = rippleAdderSchematic(full_adder, 8);
+    Managers managers;
+    auto circuit = adder->build(managers);
+
+    MemoryReport report(managers);
+    report.addCircuit(*circuit->sub_circuits[0]);
+    const size_t one_adder = report.circuits;
+    report.addCircuit(*circuit);
+    REQUIRE(report.circuits > 9 * one_adder);
+}
+
+TEST_CASE("build fails before lending storage when over the memory budget", "[memoryReport]")
+{
+    auto schematic = randomSchematic(2, 16, 2000, 16, false);
+
+    // The actual footprint of a single build
+    Managers reference;
+    auto reference_circuit = schematic->build(reference);
+    reference.tick();
+    MemoryReport actual(reference);
+    actual.addCircuit(*reference_circuit);
+
+    BuildOptions options;
+    options.memory_budget = actual.total() / 4;
+    Managers managers;
+    REQUIRE_THROWS(schematic->build(managers, options));
+    REQUIRE(managers.arena->size() == 0);
+    REQUIRE(managers.socketController->getSockets().empty());
+
+    options.memory_budget = actual.total() * 2;
+    auto circuit = schematic->build(managers, options);
+    // The budget covers everything the managers hold, so a second copy does not fit anymore
+    options.memory_budget = MemoryReport(managers).total() + 1024;
+    REQUIRE_THROWS(schematic->build(managers, options));
+}
+
+TEST_CASE("The memory budget counts a word for every bridge too wide to share one", "[memoryReport]")
+{
+    auto schematic = CircuitSchematic::create("wide");
+    for (int i = 0; i < 4096; i++) {
+        schematic->addWireBridge({ { "w" + std::to_string(i), { STORAGE_SIZE / 2 + 1 } } });
+    }
+    Managers reference;
+    auto reference_circuit = schematic->build(reference);
+    MemoryReport actual(reference);
+    actual.addCircuit(*reference_circuit);
+    REQUIRE(reference.random_access_data_bank->size() == 4096);
+
+    // The estimate holds the words and port handles of the build, and some bookkeeping on top
+    BuildOptions options;
+    options.memory_budget = actual.bank_words + actual.accessors;
+    Managers managers;
+    REQUIRE_THROWS(schematic->build(managers, options));
+    options.memory_budget = actual.total();
+    REQUIRE_NOTHROW(schematic->build(managers, options));
+}
@@ -0,0 +1,42 @@
+#include "circuitGenerators.hpp"
+#include "managers.hpp"
+#include "workerPool.hpp"
+#include <catch2/catch_amalgamated.hpp>
+
+TEST_CASE("WorkerPool runs every task once per batch", "[workerPool]")
+{
+    WorkerPool pool(4);
+    REQUIRE(pool.threadCount() == 4);
+    std::vector<std::atomic<int>> counts(1000);
+    for (size_t batch = 0; batch < 20; batch++) {
+        pool.run(counts.size(), [&](size_t index) { counts[index]++; });
+    }
+    for (auto& count : counts) {
+        REQUIRE(count == 20);
+    }
+}
+
+TEST_CASE("Parallel ticks match single threaded ticks", "[parallelScheduler][Manager]")
+{
+    const bool feedback = GENERATE(false, true);
+    const size_t threads = GENERATE(1, 3, 8);
+    auto cs = randomSchematic(7, 16, 3000, 32, feedback);
+    Managers single, parallel;
+    auto single_circuit = cs->build(single);
+    auto parallel_circuit = cs->build(parallel);
+    parallel.parallelScheduler->setThreadCount(threads);
+    std::mt19937_64 rng(threads);
+
+    for (size_t t = 0; t < 30; t++) {
+        if (t % 5 == 0) {
+            const std::string port = "in_" + std::to_string(rng() % 16);
+            const bool value = rng() % 2;
+            single_circuit->exposed_ports[port].set(value);
+            parallel_circuit->exposed_ports[port].set(value);
+        }
+        single.tick();
+        parallel.tickParallel();
+        REQUIRE(circuitState(*single_circuit) == circuitState(*parallel_circuit));
+    }
+    REQUIRE(parallel.parallelScheduler->getSocketGroupCount() <= threads);
+}
@@ -0,0 +1,109 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include "circuitGenerators.hpp"
+#include "circuitSchematic.hpp"
+#include "portTable.hpp"
+
+TEST_CASE("Port layouts intern names", "[portTable]")
+{
+    PortLayout layout;
+    REQUIRE(layout.add("a") == 0);
+    REQUIRE(layout.add("b") == 1);
+    REQUIRE(layout.add("a") == 0);
+    layout.alias("c", 1);
+    REQUIRE(layout.size() == 3);
+    REQUIRE(layout.slotCount() == 2);
+    REQUIRE(layout.find("c") == 1);
+    REQUIRE(layout.find("d") == PortLayout::NONE);
+
+    PortLayout copy = layout;
+    layout.add("d");
+    REQUIRE(copy.find("b") == 1);
+    REQUIRE(copy.find("d") == PortLayout::NONE);
+}
+
+TEST_CASE("Port tables behave like maps", "[portTable]")
+{
+    auto storage = std::make_shared<BoolStorage>();
+    PortTable table;
+    table["x"] = BoolStorageAccessor(0, 4, storage);
+    table["y"] = BoolStorageAccessor(4, 4, storage);
+    REQUIRE(table.size() == 2);
+    REQUIRE(table.count("x") == 1);
+    REQUIRE(table.count("z") == 0);
+    REQUIRE_THROWS(table.at("z"));
+
+    table["y"].set(5);
+    REQUIRE(table.at("y").get() == 5);
+    std::vector<std::string> names;
+    for (const auto& [name, accessor] : table) {
+        names.push_back(name);
+    }
+    REQUIRE(names == std::vector<std::string> { "x", "y" });
+
+    // Copies of a table get names of their own
+    PortTable copy = table;
+    copy["z"] = BoolStorageAccessor(8, 1, storage);
+    table["w"] = BoolStorageAccessor(9, 1, storage);
+    REQUIRE(copy.count("z") == 1);
+    REQUIRE(copy.count("w") == 0);
+    REQUIRE(table.count("z") == 0);
+    REQUIRE(table.size() == 3);
+}
+
+TEST_CASE("Circuits built from one schematic share their port names", "[portTable]")
+{
+    auto full_adder = fullAdderSchematic();
+    Managers m;
+    auto first = full_adder->build(m);
+    auto second = full_adder->build(m);
+    REQUIRE(&first->bool_storage_access_map.getLayout() == &second->bool_storage_access_map.getLayout());
+    REQUIRE(&first->exposed_ports.getLayout() == &second->exposed_ports.getLayout());
+
+    // Adding a name to one circuit leaves the other untouched
+    first->bool_storage_access_map["extra"] = first->exposed_ports["sum_0"];
+    REQUIRE(first->bool_storage_access_map.count("extra") == 1);
+    REQUIRE(second->bool_storage_access_map.count("extra") == 0);
+
+    // Changing the schematic gives new circuits a new layout
+    full_adder->addWireBridge({ { "spare", { 1 } } });
+    auto third = full_adder->build(m);
+    REQUIRE(third->bool_storage_access_map.count("spare_0") == 1);
+    REQUIRE(second->bool_storage_access_map.count("spare_0") == 0);
+}
+
+TEST_CASE("Port tables store ports in the arena as handles", "[portTable]")
+{
+    auto full_adder = fullAdderSchematic();
+    Managers m;
+    auto circuit = full_adder->build(m);
+    PortTable& ports = circuit->bool_storage_access_map;
+    const size_t bytes = ports.accessorBytes();
+    REQUIRE(bytes < ports.getLayout().slotCount() * sizeof(BoolStorageAccessor) / 2);
+
+    // Lookups by value leave the table as it is
+    const auto sum = ports.at("sum_0");
+    REQUIRE(sum.getBuffer() == circuit->exposed_ports.at("sum_0").getBuffer());
+    REQUIRE(m.arena->wordIndex(sum.getBuffer().get()) != StorageArena::NONE);
+    for (const auto& [name, accessor] : ports) {
+        REQUIRE(accessor.getSocketSize() == 1);
+    }
+    REQUIRE(ports.accessorBytes() == bytes);
+
+    // References stay valid and keep what is assigned to them
+    auto standalone = std::make_shared<BoolStorage>();
+    BoolStorageAccessor& carry = ports["carry_0"];
+    ports["input_0"] = BoolStorageAccessor(3, 1, standalone);
+    carry.set(1);
+    REQUIRE(ports.at("carry_0").get() == 1);
+    ports.at("input_0").set(1);
+    REQUIRE(*standalone == 8);
+
+    // Ports expire with the arena like the accessors lent by data banks
+    PortTable expired;
+    {
+        Managers other;
+        expired = full_adder->build(other)->exposed_ports;
+    }
+    REQUIRE_THROWS(expired.at("sum_0").get());
+}
@@ -1,6 +1,8 @@
 #include "dataBank.hpp"
 #include "socketController.hpp"
 #include <catch2/catch_amalgamated.hpp>
+#include <random>
+#include <tuple>
 
 TEST_CASE("SocketController is a class", "[socketController]")
 {
@@ -142,4 +144,81 @@ TEST_CASE("Chain link order of creation is irrelevant with databanks", "[socketC
     sc.tick();
     sc.tick();
     REQUIRE(bsa.get() == 0b101010);
-}
\ No newline at end of file
+}
+TEST_CASE("SocketController merges sockets between the same words into one transfer", "[socketController]")
+{
+    SocketController sc;
+    DataBank<1> db;
+    auto [from] = db.lendStorage();
+    auto [to] = db.lendStorage();
+    for (size_t i = 0; i < STORAGE_SIZE; i++) {
+        sc.addSocket(BoolStorageAccessor(i, 1, from), BoolStorageAccessor(i, 1, to));
+    }
+    REQUIRE(sc.getPlan().size() == 1);
+    REQUIRE(sc.getPlan()[0].whole_word);
+
+    *from.lock() = 0xF0F0F0F0F0F0F0F0ull;
+    sc.tick();
+    REQUIRE(to.lock()->to_ullong() == 0xF0F0F0F0F0F0F0F0ull);
+
+    // A shifted socket cannot be merged into a plain copy
+    sc.addSocket(BoolStorageAccessor(0, 4, to), BoolStorageAccessor(4, 4, from));
+    REQUIRE(sc.getPlan().size() == 2);
+    REQUIRE_FALSE(sc.getPlan()[1].whole_word);
+}
+
+TEST_CASE("Compiled socket plan matches per-socket transfers", "[socketController]")
+{
+    std::mt19937_64 rng(GENERATE(1, 2, 3, 4, 5));
+    SocketController sc;
+    DataBank<1> db;
+    std::vector<std::shared_ptr<BoolStorage>> words;
+    std::vector<BoolStorage> reference;
+    for (size_t i = 0; i < 4; i++) {
+        words.push_back(db.lendStorage()[0].lock());
+        *words.back() = rng();
+        reference.push_back(*words.back());
+    }
+    std::vector<std::tuple<size_t, size_t, size_t, size_t, size_t>> sockets;
+    for (size_t i = 0; i < 40; i++) {
+        const size_t size = rng() % STORAGE_SIZE + 1;
+        const size_t from_offset = rng() % (STORAGE_SIZE - size + 1);
+        const size_t to_offset = rng() % (STORAGE_SIZE - size + 1);
+        const size_t from = rng() % words.size(), to = rng() % words.size();
+        sockets.emplace_back(from, from_offset, to, to_offset, size);
+        sc.addSocket(BoolStorageAccessor(from_offset, size, words[from]), BoolStorageAccessor(to_offset, size, words[to]));
+    }
+
+    for (size_t t = 0; t < 3; t++) {
+        sc.tick();
+        for (auto [from, from_offset, to, to_offset, size] : sockets) {
+            const auto mask = ONES >> (STORAGE_SIZE - size);
+            const auto bits = (reference[from] >> from_offset) & mask;
+            reference[to] = (reference[to] & ~(mask << to_offset)) | (bits << to_offset);
+        }
+        for (size_t i = 0; i < words.size(); i++) {
+            REQUIRE(*words[i] == reference[i]);
+        }
+    }
+}
+
+TEST_CASE("SocketController reports the locality of its sockets", "[socketController]")
+{
+    SocketController sc;
+    DataBank<1> db;
+    std::vector<std::shared_ptr<BoolStorage>> words;
+    for (size_t i = 0; i < 8; i++) {
+        words.push_back(db.lendStorage()[0].lock());
+    }
+    REQUIRE(sc.getLocality(db.getArena()).distance == 0);
+    sc.addSocket(BoolStorageAccessor(0, 1, words[0]), BoolStorageAccessor(0, 1, words[1]));
+    sc.addSocket(BoolStorageAccessor(0, 1, words[7]), BoolStorageAccessor(0, 1, words[2]));
+    sc.addSocket(BoolStorageAccessor(0, 1, words[3]), BoolStorageAccessor(1, 1, words[3]));
+    // Words outside the arena are ignored
+    auto outside = std::make_shared<BoolStorage>();
+    sc.addSocket(BoolStorageAccessor(0, 1, outside), BoolStorageAccessor(0, 1, words[4]));
+    const auto locality = sc.getLocality(db.getArena());
+    REQUIRE(locality.distance == 2.0);
+    // (|7 - 0| + |2 - 1|) / 2 and (|3 - 7| + |3 - 2|) / 2
+    REQUIRE(locality.stride == 3.25);
+}
@@ -0,0 +1,61 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include "circuitGenerators.hpp"
+#include "managers.hpp"
+#include "storageArena.hpp"
+
+TEST_CASE("Arena words are addressed by index", "[storageArena]")
+{
+    StorageArena arena;
+    REQUIRE(arena.allocateChunk() == 0);
+    REQUIRE(arena.allocateChunk() == StorageArena::CHUNK_SIZE);
+    REQUIRE(arena.size() == 2 * StorageArena::CHUNK_SIZE);
+    for (uint32_t index : { 0u, 1u, 255u, 256u, 511u }) {
+        REQUIRE(arena.wordIndex(&arena.word(index)) == index);
+    }
+    BoolStorage outside;
+    REQUIRE(arena.wordIndex(&outside) == StorageArena::NONE);
+}
+
+TEST_CASE("Handles access the same bits as accessors", "[storageArena]")
+{
+    DataBank<2> db;
+    auto [a, b] = db.lendBools(5);
+    auto [c, d] = db.lendBools(7);
+    StorageHandle handle_c = db.getArena().handle(c);
+    StorageHandle handle_d = db.getArena().handle(d);
+    REQUIRE(handle_c.word == handle_d.word - StorageArena::CHUNK_SIZE);
+    REQUIRE(handle_c.bit_offset == 5);
+    REQUIRE(handle_c.size == 7);
+
+    db.getArena().set(handle_c, 0b1111111111);
+    REQUIRE(c.get() == 0b1111111);
+    REQUIRE(a.get() == 0);
+    c.set(0b0101010);
+    REQUIRE(db.getArena().get(handle_c) == 0b0101010);
+    db.getArena().add(handle_c, 1);
+    REQUIRE(c.get() == 0b0101011);
+    db.getArena().clear(handle_c);
+    REQUIRE(c.get() == 0);
+
+    auto outside = std::make_shared<BoolStorage>();
+    REQUIRE_THROWS(db.getArena().handle(BoolStorageAccessor(0, 1, outside)));
+}
+
+TEST_CASE("Managers keep all bank words in one arena", "[storageArena]")
+{
+    auto full_adder = fullAdderSchematic();
+    Managers m;
+    auto circuit = full_adder->build(m);
+    // One chunk for the wire bridges and one per dimension of the and, or and xor banks
+    REQUIRE(m.arena->size() == 10 * StorageArena::CHUNK_SIZE);
+
+    StorageHandle input = m.arena->handle(circuit->exposed_ports["input_0"]);
+    StorageHandle sum = m.arena->handle(circuit->exposed_ports["sum_0"]);
+    m.arena->set(input, 1);
+    for (int i = 0; i < 10; i++) {
+        m.tick();
+    }
+    REQUIRE(m.arena->get(sum) == 1);
+    REQUIRE(circuit->exposed_ports["sum_0"].get() == 1);
+}
@@ -0,0 +1,126 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include "circuitGenerators.hpp"
+#include "waveformRecorder.hpp"
+#include <map>
+#include <sstream>
+
+namespace {
+
+/// @brief The values of a VCD file after replaying all changes, by port name, and the timestamps in it
+struct Replay {
+    std::map<std::string, std::string> values;
+    std::vector<uint64_t> times;
+    size_t changes = 0;
+
+    explicit Replay(const std::string& vcd)
+    {
+        std::istringstream in(vcd);
+        std::string line;
+        std::map<std::string, std::vector<std::string>> names;
+        std::map<std::string, std::string> by_id;
+        bool definitions = true;
+        while (std::getline(in, line)) {
+            std::istringstream tokens(line);
+            if (definitions) {
+                std::string keyword, type, size, id, name;
+                tokens >> keyword;
+                if (keyword == "$var") {
+                    tokens >> type >> size >> id >> name;
+                    names[id].push_back(name);
+                } else if (keyword == "$enddefinitions") {
+                    definitions = false;
+                }
+                continue;
+            }
+            if (line[0] == '#') {
+                times.push_back(std::stoull(line.substr(1)));
+                continue;
+            }
+            std::string value, id;
+            if (line[0] == 'b') {
+                tokens >> value >> id;
+                value = value.substr(1);
+            } else {
+                value = line.substr(0, 1);
+                id = line.substr(1);
+            }
+            changes++;
+            for (const auto& name : names.at(id)) {
+                values[name] = value;
+            }
+        }
+    }
+
+    unsigned long long get(const std::string& name) const { return std::stoull(values.at(name), nullptr, 2); }
+};
+
+}
+
+TEST_CASE("WaveformRecorder writes the values of traced ports", "[waveformRecorder]")
+{
+    auto full_adder = fullAdderSchematic();
+    auto adder = rippleAdderSchematic(full_adder, 8);
+    Managers managers;
+    auto circuit = adder->build(managers);
+
+    std::ostringstream vcd;
+    WaveformRecorder recorder(vcd);
+    recorder.addCircuit("adder", *circuit);
+    REQUIRE(recorder.signalCount() > 0);
+
+    const size_t a = 77, b = 150;
+    for (size_t i = 0; i < 8; i++) {
+        circuit->exposed_ports["a_" + std::to_string(i)].set((a >> i) & 1);
+        circuit->exposed_ports["b_" + std::to_string(i)].set((b >> i) & 1);
+    }
+    for (uint64_t time = 0; time < 32; time++) {
+        recorder.sample(time);
+        managers.tick();
+    }
+    recorder.sample(32);
+    // Nothing changes once the adder settled, so the last samples do not show up in the file
+    recorder.sample(33);
+    REQUIRE_THROWS(recorder.sample(33));
+    recorder.close();
+
+    Replay replay(vcd.str());
+    REQUIRE(replay.changes == recorder.getChangeCount());
+    REQUIRE(replay.times.front() == 0);
+    REQUIRE(replay.times.back() < 32);
+    for (const auto [name, port] : circuit->bool_storage_access_map) {
+        INFO(name);
+        REQUIRE(replay.get(name) == port.get().to_ullong());
+    }
+    size_t sum = 0;
+    for (size_t i = 0; i < 8; i++) {
+        sum |= replay.get("sum_" + std::to_string(i)) << i;
+    }
+    sum |= replay.get("carry_0") << 8;
+    REQUIRE(sum == a + b);
+}
+
+TEST_CASE("WaveformRecorder shares signals between ports on the same bits", "[waveformRecorder]")
+{
+    auto cs = CircuitSchematic::create("aliases");
+    cs->addWireBridge({ { "bus", { 4, 4 } }, { "wide", { 8 } } });
+    Managers managers;
+    auto circuit = cs->build(managers);
+
+    std::ostringstream vcd;
+    {
+        WaveformRecorder recorder(vcd);
+        recorder.addCircuit("top", *circuit);
+        REQUIRE(recorder.signalCount() == 3);
+        recorder.sample(0);
+        circuit->bool_storage_access_map["wide_0"].set(0xa5);
+        recorder.sample(1);
+        REQUIRE_THROWS(recorder.addPort("top", "late", circuit->bool_storage_access_map["bus_0"]));
+    }
+
+    Replay replay(vcd.str());
+    REQUIRE(replay.get("bus_0") == 0x5);
+    REQUIRE(replay.get("bus_1") == 0xa);
+    REQUIRE(replay.get("wide_0") == 0xa5);
+    REQUIRE(replay.times == std::vector<uint64_t> { 0, 1 });
+}
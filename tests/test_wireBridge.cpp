@@ -1,3 +1,4 @@
+#include "circuitSchematic.hpp"
 #include "managers.hpp"
 #include "wireBridge.hpp"
 #include <catch2/catch_amalgamated.hpp>
@@ -85,3 +86,55 @@ TEST_CASE("Data transfer between bridges", "[Managers][wireBridge]")
         REQUIRE(wb2[1][0].get() == 0b11);
     }
 }
+
+TEST_CASE("Wire bridges are packed into shared words", "[wireBridge]")
+{
+    DataBank<1> db;
+    std::vector<std::vector<std::vector<BoolStorageAccessor>>> bridges;
+    for (size_t i = 0; i < 64; i++) {
+        bridges.push_back(wireBridge(db, { { 1, 2 }, { 3 } }));
+    }
+    auto usage = db.getUsage();
+    REQUIRE(usage.bits_used == 64 * 3);
+    REQUIRE(usage.bits_allocated == usage.words * STORAGE_SIZE);
+    // Bridges never straddle two words
+    const size_t per_word = STORAGE_SIZE / 3;
+    REQUIRE(usage.words == (64 + per_word - 1) / per_word);
+
+    // Views of the same bridge still alias, while bridges sharing a word stay independent
+    for (size_t i = 0; i < bridges.size(); i++) {
+        bridges[i][1][0].set(i % 8);
+    }
+    for (size_t i = 0; i < bridges.size(); i++) {
+        REQUIRE(bridges[i][0][0].get() == (i % 8 & 0b1));
+        REQUIRE(bridges[i][0][1].get() == (i % 8 >> 1));
+        REQUIRE(bridges[i][1][0].get() == i % 8);
+    }
+}
+
+TEST_CASE("Wire bridge views cannot exceed STORAGE_SIZE", "[wireBridge]")
+{
+    DataBank<1> db;
+    REQUIRE_THROWS(wireBridge(db, { { STORAGE_SIZE, 1 } }));
+    REQUIRE_NOTHROW(wireBridge(db, { { STORAGE_SIZE } }));
+}
+
+TEST_CASE("A bus as wide as a storage word moves in a single transfer", "[wireBridge]")
+{
+    auto cs = CircuitSchematic::create("bus");
+    cs->addWireBridge({ { "from", { STORAGE_SIZE } } });
+    cs->addWireBridge({ { "to", { STORAGE_SIZE } } });
+    cs->addConnection("from_0", "to_0");
+    Managers m;
+    auto circuit = cs->build(m);
+
+    BoolStorage value;
+    for (size_t i = 0; i < STORAGE_SIZE; i += 3) {
+        value.set(i);
+    }
+    circuit->bool_storage_access_map["from_0"].set(value);
+    m.tick();
+    REQUIRE(circuit->bool_storage_access_map["to_0"].get() == value);
+    REQUIRE(m.socketController->getPlan().size() == 1);
+    REQUIRE(m.socketController->getPlan()[0].whole_word);
+}